@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BENCH_HPP
+#define LIBBITCOIN_BENCH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace libbitcoin {
+namespace bench {
+
+/// A case runs once per measurement and returns the operations it performed.
+typedef std::function<size_t()> case_handler;
+
+struct benchmark
+{
+    std::string name;
+    case_handler handler;
+};
+
+/// The registry of all cases, in registration order.
+std::vector<benchmark>& cases();
+
+/// The number of heap allocations (operator new) made by the process.
+size_t allocations();
+
+/// The number of bytes requested by those allocations.
+size_t allocated_bytes();
+
+/// Registers a case at static initialization.
+struct registrar
+{
+    registrar(const std::string& name, case_handler handler)
+    {
+        cases().push_back({ name, handler });
+    }
+};
+
+} // namespace bench
+} // namespace libbitcoin
+
+#define BENCH_CONCATENATE_(left, right) left##right
+#define BENCH_CONCATENATE(left, right) BENCH_CONCATENATE_(left, right)
+
+/// Define a case as the body of a function returning its operation count.
+#define BENCHMARK(name) \
+    static size_t BENCH_CONCATENATE(bench_, name)(); \
+    static const libbitcoin::bench::registrar \
+        BENCH_CONCATENATE(registrar_, name)(#name, \
+            &BENCH_CONCATENATE(bench_, name)); \
+    static size_t BENCH_CONCATENATE(bench_, name)()
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include "bench.hpp"
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+// Measure the promotion of chain state through a chain of headers, as in
+// headers-first synchronization. An operation is one chain_state(parent,
+// header) construction. Header hashes are cached before measurement.
+
+static const size_t header_count = 10000;
+static const chain_state::checkpoints no_checkpoints{};
+
+static const header::list& headers()
+{
+    static header::list headers;
+
+    if (headers.empty())
+    {
+        auto previous = null_hash;
+        headers.reserve(header_count);
+
+        for (uint32_t height = 0; height < header_count; ++height)
+        {
+            headers.emplace_back(2, previous, null_hash, 600 * height,
+                retarget_proof_of_work_limit, 0);
+            previous = headers.back().hash();
+        }
+    }
+
+    return headers;
+}
+
+static size_t promote(uint32_t forks)
+{
+    chain_state::data data;
+    data.height = 1;
+    data.hash = headers()[1].hash();
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bits.self = retarget_proof_of_work_limit;
+    data.bits.ordered = { retarget_proof_of_work_limit };
+    data.version.self = 2;
+    data.version.ordered = { 2 };
+    data.timestamp.self = 600;
+    data.timestamp.retarget = 0;
+    data.timestamp.ordered = { 0 };
+
+    auto state = std::make_shared<chain_state>(std::move(data),
+        no_checkpoints, forks);
+
+    for (size_t height = 2; height < header_count; ++height)
+        state = std::make_shared<chain_state>(*state, headers()[height]);
+
+    return header_count - 2;
+}
+
+// Bits, 1000 versions and 11 timestamps.
+BENCHMARK(chain_state_promote_header_mainnet)
+{
+    return promote(rule_fork::retarget | rule_fork::bip34_activations);
+}
+
+// Up to 2016 bits, 100 versions and 11 timestamps.
+BENCHMARK(chain_state_promote_header_testnet)
+{
+    return promote(rule_fork::easy_blocks | rule_fork::retarget |
+        rule_fork::bip34_activations);
+}
+
+// Bits and 11 timestamps (bip90 fixes bip34-based activation heights).
+BENCHMARK(chain_state_promote_header_bip90)
+{
+    return promote(rule_fork::retarget | rule_fork::bip34_activations |
+        rule_fork::bip90_rule);
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <bitcoin/bitcoin.hpp>
+#include "bench.hpp"
+
+using namespace bc;
+
+// Compare throughput of the asio service and the work-stealing executor for
+// short concurrent jobs, posted externally (flat) and from jobs (fan-out).
+
+static const size_t flat_jobs = 1000000;
+static const size_t fanout_roots = 1000;
+static const size_t fanout_children = 1000;
+
+static size_t threads()
+{
+    return std::max(std::thread::hardware_concurrency(), 2u);
+}
+
+// Blocks until the expected number of jobs has completed.
+class latch
+{
+public:
+    latch(size_t count)
+      : count_(count)
+    {
+    }
+
+    // The waiter tests the count under the mutex, so no wakeup is lost.
+    void count_down()
+    {
+        if (--count_ != 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return count_ == 0; });
+    }
+
+private:
+    std::atomic<size_t> count_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+};
+
+// The job is trivial so that dispatch cost dominates.
+static void complete_job(latch& complete)
+{
+    complete.count_down();
+}
+
+BENCHMARK(threadpool_concurrent_flat)
+{
+    threadpool pool(threads());
+    latch complete(flat_jobs);
+
+    for (size_t index = 0; index < flat_jobs; ++index)
+        pool.service().post(std::bind(complete_job, std::ref(complete)));
+
+    complete.wait();
+    return flat_jobs;
+}
+
+BENCHMARK(executor_concurrent_flat)
+{
+    executor pool(threads());
+    latch complete(flat_jobs);
+
+    for (size_t index = 0; index < flat_jobs; ++index)
+        pool.concurrent(std::bind(complete_job, std::ref(complete)));
+
+    complete.wait();
+    return flat_jobs;
+}
+
+BENCHMARK(threadpool_concurrent_fanout)
+{
+    threadpool pool(threads());
+    auto& service = pool.service();
+    latch complete(fanout_roots * fanout_children);
+
+    for (size_t root = 0; root < fanout_roots; ++root)
+        service.post([&]()
+        {
+            for (size_t child = 0; child < fanout_children; ++child)
+                service.post(std::bind(complete_job, std::ref(complete)));
+        });
+
+    complete.wait();
+    return fanout_roots * fanout_children;
+}
+
+BENCHMARK(executor_concurrent_fanout)
+{
+    executor pool(threads());
+    latch complete(fanout_roots * fanout_children);
+
+    for (size_t root = 0; root < fanout_roots; ++root)
+        pool.concurrent([&]()
+        {
+            for (size_t child = 0; child < fanout_children; ++child)
+                pool.concurrent(std::bind(complete_job, std::ref(complete)));
+        });
+
+    complete.wait();
+    return fanout_roots * fanout_children;
+}
+
+BENCHMARK(dispatcher_parallel_for_threadpool)
+{
+    threadpool pool(threads());
+    dispatcher dispatch(pool, "bench");
+    std::atomic<size_t> total(0);
+
+    dispatch.parallel_for(flat_jobs, [&total](size_t)
+    {
+        total += 1;
+        return true;
+    });
+
+    return total;
+}
+
+BENCHMARK(dispatcher_parallel_for_executor)
+{
+    threadpool pool(1);
+    executor concurrent(threads());
+    dispatcher dispatch(pool, concurrent, "bench");
+    std::atomic<size_t> total(0);
+
+    dispatch.parallel_for(flat_jobs, [&total](size_t)
+    {
+        total += 1;
+        return true;
+    });
+
+    return total;
+}
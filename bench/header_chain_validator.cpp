@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <bitcoin/bitcoin.hpp>
+#include "bench.hpp"
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+// Measure the validation of a headers message of mined (regtest) headers, as
+// in headers-first synchronization. An operation is one header. Headers are
+// copied without their cached hashes, so each run hashes every header.
+
+static const size_t header_count = 2000;
+static const uint32_t regtest_bits = 0x207fffff;
+static const uint32_t regtest_forks = rule_fork::bip16_rule;
+static const chain_state::checkpoints no_checkpoints{};
+
+static size_t threads()
+{
+    return std::max(std::thread::hardware_concurrency(), 2u);
+}
+
+// The parent header (at height one), followed by the message headers.
+static const header::list& mined()
+{
+    static header::list headers;
+
+    if (headers.empty())
+    {
+        auto previous = null_hash;
+        headers.reserve(header_count + 1);
+
+        for (uint32_t height = 0; height <= header_count; ++height)
+        {
+            header value(4, previous, null_hash, 600 * (height + 1),
+                regtest_bits, 0);
+
+            while (!value.is_valid_proof_of_work(false))
+                value.set_nonce(value.nonce() + 1);
+
+            headers.push_back(value);
+            previous = value.hash();
+        }
+    }
+
+    return headers;
+}
+
+static header::list message()
+{
+    header::list headers;
+    headers.reserve(header_count);
+
+    for (auto it = mined().begin() + 1; it != mined().end(); ++it)
+        headers.emplace_back(it->version(), it->previous_block_hash(),
+            it->merkle(), it->timestamp(), it->bits(), it->nonce());
+
+    return headers;
+}
+
+static chain_state::ptr parent()
+{
+    const auto& value = mined().front();
+
+    chain_state::data data;
+    data.height = 1;
+    data.hash = value.hash();
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bits.self = value.bits();
+    data.bits.ordered = { value.bits() };
+    data.version.self = value.version();
+    data.version.ordered = { value.version() };
+    data.timestamp.self = value.timestamp();
+    data.timestamp.retarget = 0;
+    data.timestamp.ordered = { 0 };
+
+    return std::make_shared<chain_state>(std::move(data), no_checkpoints,
+        regtest_forks);
+}
+
+BENCHMARK(header_chain_validator_sequential)
+{
+    const auto headers = message();
+    header_chain_validator validator(parent(), no_checkpoints);
+    return validator.validate(headers) ? 0 : validator.validated();
+}
+
+BENCHMARK(header_chain_validator_dispatched)
+{
+    threadpool pool(threads());
+    dispatcher dispatch(pool, "bench");
+    const auto headers = message();
+    header_chain_validator validator(parent(), no_checkpoints);
+    return validator.validate(headers, dispatch) ? 0 : validator.validated();
+}
@@ -0,0 +1,302 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include "../test/chain/script.hpp"
+#include "bench.hpp"
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+// Measure the interpreter over representative scripts and the script test
+// vectors. An operation is one script::evaluate, which runs the interpreter
+// over the input script, the prevout script and any p2sh embedded script
+// (without the template fast paths).
+
+static const size_t signed_rounds = 1000;
+static const size_t multisig_rounds = 100;
+static const size_t unsigned_rounds = 100000;
+static const size_t vector_rounds = 100;
+static const size_t nesting_depth = 100;
+static const uint32_t forks = rule_fork::all_rules;
+
+static ec_secret make_secret(uint8_t seed)
+{
+    ec_secret secret{ {} };
+    secret.back() = seed;
+    return secret;
+}
+
+static data_chunk make_point(uint8_t seed)
+{
+    ec_compressed point;
+    secret_to_public(point, make_secret(seed));
+    return to_chunk(point);
+}
+
+static transaction make_tx()
+{
+    return transaction
+    {
+        1, 0,
+        input::list{ input{ output_point{ null_hash, 0 }, script{}, 0 } },
+        output::list{ output{ 1, script{} } }
+    };
+}
+
+static data_chunk make_endorsement(uint8_t seed, const script& script_code,
+    const transaction& tx)
+{
+    endorsement out;
+    script::create_endorsement(out, make_secret(seed), script_code, tx, 0,
+        sighash_algorithm::all);
+    return out;
+}
+
+// This mirrors the construction of script test vector transactions.
+static transaction make_tx(const script_test& test)
+{
+    script input_script;
+    script output_script;
+
+    if (!input_script.from_string(test.input) ||
+        !output_script.from_string(test.output))
+        return{};
+
+    output_point outpoint;
+    outpoint.validation.cache.set_script(std::move(output_script));
+
+    return transaction
+    {
+        test.version,
+        test.locktime,
+        input::list
+        {
+            input{ std::move(outpoint), std::move(input_script),
+                test.input_sequence }
+        },
+        output::list{}
+    };
+}
+
+static size_t evaluate(const transaction& tx, const script& input_script,
+    const script& prevout_script, size_t rounds)
+{
+    for (size_t round = 0; round < rounds; ++round)
+        script::evaluate(tx, 0, forks, input_script, prevout_script);
+
+    return rounds;
+}
+
+BENCHMARK(interpreter_pay_key_hash)
+{
+    const auto tx = make_tx();
+    const auto point = make_point(1);
+    const script prevout(script::to_pay_key_hash_pattern(
+        bitcoin_short_hash(point)));
+
+    const script input(operation::list
+    {
+        operation(make_endorsement(1, prevout, tx)),
+        operation(point)
+    });
+
+    if (script::evaluate(tx, 0, forks, input, prevout))
+        return 0;
+
+    return evaluate(tx, input, prevout, signed_rounds);
+}
+
+BENCHMARK(interpreter_pay_script_hash_2_of_3)
+{
+    const auto tx = make_tx();
+    const script redeem(script::to_pay_multisig_pattern(2,
+        { make_point(1), make_point(2), make_point(3) }));
+
+    const auto redeem_data = redeem.to_data(false);
+    const script prevout(script::to_pay_script_hash_pattern(
+        bitcoin_short_hash(redeem_data)));
+
+    const script input(operation::list
+    {
+        operation(opcode::push_size_0),
+        operation(make_endorsement(1, redeem, tx)),
+        operation(make_endorsement(2, redeem, tx)),
+        operation(redeem_data)
+    });
+
+    if (script::evaluate(tx, 0, forks, input, prevout))
+        return 0;
+
+    return evaluate(tx, input, prevout, signed_rounds);
+}
+
+BENCHMARK(interpreter_null_data)
+{
+    const auto tx = make_tx();
+    const script prevout(script::to_pay_null_data_pattern(
+        data_chunk(max_null_data_size, 0x42)));
+    const script input;
+
+    // A null data output is provably unspendable.
+    if (!script::evaluate(tx, 0, forks, input, prevout))
+        return 0;
+
+    return evaluate(tx, input, prevout, unsigned_rounds);
+}
+
+// The signature is of the last key, so it is checked against every key.
+BENCHMARK(interpreter_checkmultisig_worst_case)
+{
+    const auto tx = make_tx();
+    data_stack points;
+
+    for (size_t key = 1; key <= max_script_public_keys; ++key)
+        points.push_back(make_point(static_cast<uint8_t>(key)));
+
+    // The multisig pattern factory is limited to 16 keys.
+    operation::list ops{ operation(opcode::push_positive_1) };
+
+    for (const auto& point: points)
+        ops.emplace_back(point);
+
+    ops.emplace_back(number(points.size()).data());
+    ops.emplace_back(opcode::checkmultisig);
+    const script prevout(std::move(ops));
+
+    const auto last = static_cast<uint8_t>(max_script_public_keys);
+    const script input(operation::list
+    {
+        operation(opcode::push_size_0),
+        operation(make_endorsement(last, prevout, tx))
+    });
+
+    if (script::evaluate(tx, 0, forks, input, prevout))
+        return 0;
+
+    return evaluate(tx, input, prevout, multisig_rounds);
+}
+
+// Each if and endif is counted, so the depth is limited by max_counted_ops.
+BENCHMARK(interpreter_if_nesting_deep)
+{
+    const auto tx = make_tx();
+    std::string conditions;
+    std::string opens;
+    std::string closes;
+
+    for (size_t depth = 0; depth < nesting_depth; ++depth)
+    {
+        conditions += "1 ";
+        opens += "if ";
+        closes += " endif";
+    }
+
+    script prevout;
+    prevout.from_string(conditions + opens + "1" + closes);
+    const script input;
+
+    if (script::evaluate(tx, 0, forks, input, prevout))
+        return 0;
+
+    return evaluate(tx, input, prevout, unsigned_rounds);
+}
+
+BENCHMARK(interpreter_script_vectors)
+{
+    const std::vector<const script_test_list*> lists
+    {
+        &valid_bip16_scripts, &invalidated_bip16_scripts,
+        &valid_bip65_scripts, &invalid_bip65_scripts,
+        &invalidated_bip65_scripts, &valid_multisig_scripts,
+        &invalid_multisig_scripts, &valid_context_free_scripts,
+        &invalid_context_free_scripts
+    };
+
+    std::vector<transaction> transactions;
+
+    for (const auto list: lists)
+    {
+        for (const auto& test: *list)
+        {
+            auto tx = make_tx(test);
+
+            if (tx.inputs().empty())
+                return 0;
+
+            transactions.push_back(std::move(tx));
+        }
+    }
+
+    for (size_t round = 0; round < vector_rounds; ++round)
+    {
+        for (const auto& tx: transactions)
+        {
+            const auto& input = tx.inputs().front();
+            const auto& prevout = input.previous_output().validation.cache;
+            script::evaluate(tx, 0, forks, input.script(), prevout.script());
+        }
+    }
+
+    return vector_rounds * transactions.size();
+}
+
+// Each round is 1add, dup, within and verify, within max_counted_ops.
+BENCHMARK(interpreter_arithmetic)
+{
+    const auto tx = make_tx();
+    std::string rounds("0");
+
+    for (size_t round = 0; round < 50; ++round)
+        rounds += " 1add dup 0 [e803] within verify";
+
+    script prevout;
+    prevout.from_string(rounds + " [32] numequal");
+    const script input;
+
+    if (script::evaluate(tx, 0, forks, input, prevout))
+        return 0;
+
+    return evaluate(tx, input, prevout, unsigned_rounds);
+}
+
+// As interpreter_arithmetic, with each evaluation traced.
+BENCHMARK(interpreter_arithmetic_traced)
+{
+    const auto tx = make_tx();
+    std::string rounds("0");
+
+    for (size_t round = 0; round < 50; ++round)
+        rounds += " 1add dup 0 [e803] within verify";
+
+    script prevout;
+    prevout.from_string(rounds + " [32] numequal");
+    const script input;
+    evaluation_trace trace;
+
+    for (size_t round = 0; round < unsigned_rounds; ++round)
+        if (script::evaluate(tx, 0, forks, input, prevout, false, &trace))
+            return 0;
+
+    return unsigned_rounds;
+}
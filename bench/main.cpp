@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+// Allocations are counted by replacing the global operator new, which also
+// serves array new and the standard allocator (libsecp256k1 uses malloc).
+static std::atomic<size_t> allocations_(0);
+static std::atomic<size_t> allocated_bytes_(0);
+
+void* operator new(size_t size)
+{
+    ++allocations_;
+    allocated_bytes_ += size;
+    const auto block = std::malloc(size == 0 ? 1 : size);
+
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    return block;
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+namespace libbitcoin {
+namespace bench {
+
+std::vector<benchmark>& cases()
+{
+    static std::vector<benchmark> registry;
+    return registry;
+}
+
+size_t allocations()
+{
+    return allocations_;
+}
+
+size_t allocated_bytes()
+{
+    return allocated_bytes_;
+}
+
+} // namespace bench
+} // namespace libbitcoin
+
+using namespace libbitcoin::bench;
+
+// Runs each case whose name contains the optional filter argument.
+int main(int argc, char* argv[])
+{
+    typedef std::chrono::steady_clock clock;
+    typedef std::chrono::duration<double, std::nano> nanoseconds;
+    const std::string filter(argc > 1 ? argv[1] : "");
+
+    std::cout << std::left << std::setw(40) << "case"
+        << std::right << std::setw(14) << "ops"
+        << std::setw(14) << "ns/op"
+        << std::setw(16) << "ops/s"
+        << std::setw(14) << "allocs/op"
+        << std::setw(14) << "bytes/op" << std::endl;
+
+    for (const auto& item: cases())
+    {
+        if (item.name.find(filter) == std::string::npos)
+            continue;
+
+        const auto allocated = allocations();
+        const auto bytes = allocated_bytes();
+        const auto start = clock::now();
+        const auto operations = item.handler();
+        const nanoseconds elapsed = clock::now() - start;
+        const auto count = operations == 0 ? 1 : operations;
+        const auto per_operation = elapsed.count() / count;
+        const auto allocs = static_cast<double>(allocations() - allocated);
+        const auto size = static_cast<double>(allocated_bytes() - bytes);
+
+        std::cout << std::left << std::setw(40) << item.name
+            << std::right << std::setw(14) << operations
+            << std::setw(14) << std::fixed << std::setprecision(1)
+            << per_operation
+            << std::setw(16) << std::setprecision(0)
+            << (1e9 / per_operation)
+            << std::setw(14) << std::setprecision(2)
+            << (allocs / count)
+            << std::setw(14) << std::setprecision(1)
+            << (size / count) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include "bench.hpp"
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+// Measure the allocations made by script evaluation of a pay key hash input,
+// and by stack operations on key and signature sized elements, and the cost of
+// repeated signature operation counts of a pay script hash input.
+
+static const size_t evaluations = 2000;
+static const size_t stack_rounds = 1000000;
+static const size_t sigops_rounds = 1000000;
+static const uint32_t forks = rule_fork::all_rules;
+
+static ec_secret make_secret()
+{
+    ec_secret secret{ {} };
+    secret.back() = 42;
+    return secret;
+}
+
+BENCHMARK(script_evaluate_pay_key_hash)
+{
+    const auto secret = make_secret();
+    ec_compressed point;
+    secret_to_public(point, secret);
+
+    const auto prevout = script(script::to_pay_key_hash_pattern(
+        bitcoin_short_hash(point)));
+
+    transaction tx
+    {
+        1, 0,
+        input::list{ input{ output_point{ null_hash, 0 }, script{}, 0 } },
+        output::list{ output{ 1, script{} } }
+    };
+
+    endorsement endorsed;
+    script::create_endorsement(endorsed, secret, prevout, tx, 0,
+        sighash_algorithm::all);
+
+    const auto input_script = script(operation::list
+    {
+        operation(endorsed),
+        operation(to_chunk(point))
+    });
+
+    // Prime the sighash and bytecode caches and the stack arena.
+    if (script::evaluate(tx, 0, forks, input_script, prevout))
+        return 0;
+
+    for (size_t round = 0; round < evaluations; ++round)
+        script::evaluate(tx, 0, forks, input_script, prevout);
+
+    return evaluations;
+}
+
+BENCHMARK(program_stack_key_and_signature)
+{
+    const stack_element key(data_chunk(ec_compressed_size, 0x02));
+    const stack_element signature(data_chunk(max_endorsement_size, 0x30));
+    program instance;
+
+    for (size_t round = 0; round < stack_rounds; ++round)
+    {
+        instance.push_copy(signature);
+        instance.push_copy(key);
+        instance.duplicate(0);
+        instance.swap(0, 2);
+        instance.pop();
+        instance.pop();
+        instance.pop();
+    }
+
+    return stack_rounds;
+}
+
+BENCHMARK(input_sigops_pay_script_hash_multisig)
+{
+    script redeem;
+    redeem.from_string("2 [03dcfd9e580de35d8c2060d76dbf9e5561fe20febd2e64380e860a4d59f15ac864] "
+        "[02440e0304bf8d32b2012994393c6a477acf238dd6adb4c3cef5bfa72f30c9861c] "
+        "[03624505c6cc3967352cce480d8550490dd68519cd019066a4c302fdfb7d1c9934] "
+        "3 checkmultisig");
+
+    const auto redeem_data = redeem.to_data(false);
+    const auto input_script = script(operation::list
+    {
+        operation(opcode::push_size_0),
+        operation(redeem_data)
+    });
+
+    input instance{ output_point{ null_hash, 0 }, input_script, 0 };
+    instance.previous_output().validation.cache = output{ 1,
+        script(script::to_pay_script_hash_pattern(
+            bitcoin_short_hash(redeem_data))) };
+
+    size_t total = 0;
+
+    for (size_t round = 0; round < sigops_rounds; ++round)
+        total += instance.signature_operations(true);
+
+    return total == 3 * sigops_rounds ? sigops_rounds : 0;
+}
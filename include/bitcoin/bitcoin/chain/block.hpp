@@ -28,12 +28,16 @@
 #include <boost/optional.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/input_point.hpp>
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/machine/trace_collector.hpp>
 #include <bitcoin/bitcoin/utility/asio.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -54,6 +58,12 @@ public:
         code error = error::not_found;
         chain_state::ptr state = nullptr;
 
+        // Successful script verifications, such as from the transaction pool.
+        script_cache::ptr scripts = nullptr;
+
+        // Profiles of input script verifications, if tracing.
+        machine::trace_collector::ptr traces = nullptr;
+
         // Similate organization and instead just validate the block.
         bool simulate = false;
 
@@ -94,11 +104,12 @@ public:
     // Deserialization.
     //-------------------------------------------------------------------------
 
-    static block factory(const data_chunk& data);
+    static block factory(const data_chunk& data, bool hash=false);
     static block factory(std::istream& stream);
     static block factory(reader& source);
 
-    bool from_data(const data_chunk& data);
+    /// Set hash to cache header and transaction hashes from the wire bytes.
+    bool from_data(const data_chunk& data, bool hash=false);
     bool from_data(std::istream& stream);
     bool from_data(reader& source);
 
@@ -172,6 +183,14 @@ public:
     code connect(const chain_state& state) const;
     code connect_transactions(const chain_state& state) const;
 
+    /// Connect inputs concurrently, returning the code of the lowest failing
+    /// input in block order (the same code as the sequential connect).
+    code connect(const chain_state& state, dispatcher& dispatch) const;
+    code connect_transactions(const chain_state& state,
+        dispatcher& dispatch) const;
+    code connect_transactions(const chain_state& state, dispatcher& dispatch,
+        input_point& out_failure) const;
+
     // THIS IS FOR LIBRARY USE ONLY, DO NOT CREATE A DEPENDENCY ON IT.
     mutable validation validation;
 
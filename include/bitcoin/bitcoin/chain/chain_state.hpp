@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <memory>
 #include <deque>
+#include <bitcoin/bitcoin/chain/header_history.hpp>
 #include <bitcoin/bitcoin/config/checkpoint.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
@@ -163,6 +164,48 @@ public:
     bool is_under_checkpoint() const;
 
 protected:
+    /// The number of sampled versions at or above each bip34-based version.
+    struct version_counts
+    {
+        size_t bip34;
+        size_t bip66;
+        size_t bip65;
+    };
+
+    /// The values of data, with histories shared by the states of a branch
+    /// and with version counts maintained as the version sample advances.
+    struct shared_data
+    {
+        size_t height;
+        hash_digest hash;
+        hash_digest allow_collisions_hash;
+        hash_digest bip9_bit0_hash;
+
+        struct
+        {
+            uint32_t self;
+            header_history ordered;
+
+            /// The bits of the highest preceding block at a retarget height
+            /// or without limit bits (the easy blocks work requirement).
+            uint32_t easy;
+        } bits;
+
+        struct
+        {
+            uint32_t self;
+            header_history ordered;
+            version_counts counts;
+        } version;
+
+        struct
+        {
+            uint32_t self;
+            uint32_t retarget;
+            header_history ordered;
+        } timestamp;
+    };
+
     struct activations
     {
         // The forks that are active at this height.
@@ -175,9 +218,10 @@ protected:
         uint32_t maximum_transaction_version;
     };
 
-    static activations activation(const data& values, uint32_t forks);
-    static uint32_t median_time_past(const data& values, uint32_t forks);
-    static uint32_t work_required(const data& values, uint32_t forks);
+    static activations activation(const shared_data& values, uint32_t forks);
+    static uint32_t median_time_past(const shared_data& values,
+        uint32_t forks);
+    static uint32_t work_required(const shared_data& values, uint32_t forks);
 
 private:
     static size_t bits_count(size_t height, uint32_t forks);
@@ -187,23 +231,30 @@ private:
     static size_t collision_height(size_t height, uint32_t forks);
     static size_t bip9_bit0_height(size_t height, uint32_t forks);
 
-    static data to_pool(const chain_state& top);
-    static data to_block(const chain_state& pool, const block& block);
-    static data to_header(const chain_state& parent, const header& header);
+    static void count_version(version_counts& counts, uint32_t version,
+        bool add);
+
+    static uint32_t easy_bits(const data& values);
+    static shared_data to_shared(data&& values);
+    static shared_data to_pool(const chain_state& top);
+    static shared_data to_block(const chain_state& pool, const block& block);
+    static shared_data to_header(const chain_state& parent,
+        const header& header);
 
-    static uint32_t work_required_retarget(const data& values);
-    static uint32_t retarget_timespan(const chain_state::data& values);
+    static uint32_t work_required_retarget(const shared_data& values);
+    static uint32_t retarget_timespan(const shared_data& values);
 
     // easy blocks
-    static uint32_t easy_work_required(const data& values);
-    static uint32_t easy_time_limit(const chain_state::data& values);
+    static uint32_t easy_work_required(const shared_data& values);
+    static uint32_t easy_time_limit(const shared_data& values);
     static bool is_retarget_or_non_limit(size_t height, uint32_t bits);
     static bool is_retarget_height(size_t height);
     static size_t retarget_distance(size_t height);
 
     // This is retained as an optimization for other constructions.
     // A similar height clone can be partially computed, reducing query cost.
-    const data data_;
+    // Histories are shared, so promotion does not copy them.
+    const shared_data data_;
 
     // Configured forks are saved for state transitions.
     const uint32_t forks_;
@@ -81,14 +81,16 @@ public:
     // Deserialization.
     //-------------------------------------------------------------------------
 
-    static header factory(const data_chunk& data, bool wire=true);
+    static header factory(const data_chunk& data, bool wire=true,
+        bool hash=false);
     static header factory(std::istream& stream, bool wire=true);
     static header factory(reader& source, bool wire=true);
     static header factory(reader& source, hash_digest&& hash, bool wire=true);
     static header factory(reader& source, const hash_digest& hash,
         bool wire=true);
 
-    bool from_data(const data_chunk& data, bool wire=true);
+    /// Set hash to cache the block hash from the parsed wire bytes.
+    bool from_data(const data_chunk& data, bool wire=true, bool hash=false);
     bool from_data(std::istream& stream, bool wire=true);
     bool from_data(reader& source, bool wire=true);
     bool from_data(reader& source, hash_digest&& hash, bool wire=true);
@@ -151,6 +153,7 @@ protected:
 
     void reset();
     void invalidate_cache() const;
+    void cache_hash(data_slice wire);
 
 private:
     typedef std::shared_ptr<hash_digest> hash_ptr;
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_HEADER_CHAIN_VALIDATOR_HPP
+#define LIBBITCOIN_CHAIN_HEADER_CHAIN_VALIDATOR_HPP
+
+#include <cstddef>
+#include <bitcoin/bitcoin/chain/chain_state.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Validates batches of headers extending a branch, such as the headers of a
+/// headers message. The context-free checks (linkage, proof of work and
+/// checkpoints) are independent across headers and may be dispatched, while
+/// the contextual rules (work required, median time past and version) are
+/// applied in one pass that promotes the chain state from header to header.
+/// This class is not thread safe.
+class BC_API header_chain_validator
+  : noncopyable
+{
+public:
+    /// The parent is the state of the header preceding the first batch.
+    /// Checkpoints must be those of the parent state.
+    header_chain_validator(chain_state::ptr parent,
+        const chain_state::checkpoints& checkpoints);
+
+    /// Validate headers that extend the tip, returning the code of the first
+    /// invalid header (as if each header were checked and then accepted in
+    /// order). The tip advances over the valid headers, and the state and
+    /// height of each valid header is set on its validation member.
+    code validate(const header::list& headers);
+    code validate(const header::list& headers, dispatcher& dispatch);
+
+    /// The state of the last valid header (or of the parent).
+    chain_state::ptr tip() const;
+
+    /// The number of valid headers since construct.
+    size_t validated() const;
+
+private:
+    code check(const header::list& headers, size_t index) const;
+    code accept(const header::list& headers, size_t checked,
+        const code& failure);
+
+    chain_state::ptr tip_;
+    size_t validated_;
+    const chain_state::checkpoints& checkpoints_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
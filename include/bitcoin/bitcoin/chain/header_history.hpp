@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_HEADER_HISTORY_HPP
+#define LIBBITCOIN_CHAIN_HEADER_HISTORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A window over the values of a header field (such as timestamp), ordered
+/// by height with the highest last. Copies share storage, and a copy may be
+/// extended in amortized constant time without copying its values, so the
+/// histories of a branch of headers are shared by all of their chain states.
+/// Extending a history that is not the last to extend its storage (a fork)
+/// copies only the window into new storage. Concurrent copies and extension
+/// of copies are thread safe, concurrent extension of one instance is not.
+class BC_API header_history
+{
+public:
+    typedef std::deque<uint32_t> list;
+    typedef std::vector<uint32_t>::const_iterator const_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    // Constructors.
+    //-------------------------------------------------------------------------
+
+    header_history();
+    header_history(const list& values);
+
+    // Properties.
+    //-------------------------------------------------------------------------
+
+    bool empty() const;
+    size_t size() const;
+
+    /// Values by position, with the oldest (lowest height) at zero.
+    uint32_t operator[](size_t index) const;
+    uint32_t front() const;
+    uint32_t back() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    // Modifiers.
+    //-------------------------------------------------------------------------
+
+    /// Append the value (highest), sharing storage with copies if possible.
+    void push_back(uint32_t value);
+
+    /// Remove the oldest value, in constant time.
+    void pop_front();
+
+private:
+    // Values are written once, when their position is claimed by extension,
+    // so the values of any window within the claimed size are immutable.
+    struct storage
+    {
+        storage(size_t capacity);
+
+        std::vector<uint32_t> values;
+        std::atomic<size_t> size;
+    };
+
+    void reallocate();
+
+    std::shared_ptr<storage> storage_;
+    size_t begin_;
+    size_t end_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -29,7 +29,6 @@
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
-#include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 #include <bitcoin/bitcoin/wallet/payment_address.hpp>
 
@@ -122,7 +121,7 @@ private:
 
     addresses_ptr addresses_cache() const;
 
-    mutable upgrade_mutex mutex_;
+    // Accessed by atomic load and store.
     mutable addresses_ptr addresses_;
 
     output_point previous_output_;
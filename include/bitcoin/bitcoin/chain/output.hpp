@@ -28,7 +28,6 @@
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
-#include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 #include <bitcoin/bitcoin/wallet/payment_address.hpp>
 
@@ -134,7 +133,7 @@ private:
 
     addresses_ptr addresses_cache() const;
 
-    mutable upgrade_mutex mutex_;
+    // Accessed by atomic load and store.
     mutable addresses_ptr addresses_;
 
     uint64_t value_;
@@ -24,15 +24,16 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <vector>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
 #include <bitcoin/bitcoin/machine/script_pattern.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
-#include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
 namespace libbitcoin {
@@ -40,11 +41,38 @@ namespace chain {
 
 class transaction;
 
+/// Modification is not thread safe, operations may be decoded concurrently.
+/// An instance is limited to its bytes, shared operations and analysis caches
+/// and the validity flag, with the caches shared among copies.
 class BC_API script
 {
 public:
     typedef machine::operation operation;
 
+    /// Properties computed in one pass over the script bytes, without
+    /// decoding operations, and cached (shared among copies).
+    struct analysis
+    {
+        /// Signature operations, counting multisig as the default (legacy)
+        /// and as the preceding number of keys where positive (bip16).
+        uint32_t sigops;
+        uint32_t accurate_sigops;
+
+        /// The bip16 sigops of the last push as a p2sh embedded script, zero
+        /// unless this is a non-empty relaxed push script.
+        uint32_t embedded_sigops;
+
+        /// All operations are pushes (the relaxed set includes reserved_80).
+        bool push_only;
+        bool relaxed_push;
+
+        /// The script matches the pay script hash (bip16) pattern.
+        bool pay_script_hash;
+
+        /// No push is truncated or oversized (see is_valid_operations).
+        bool valid_operations;
+    };
+
     // Constructors.
     //-------------------------------------------------------------------------
 
@@ -120,17 +148,40 @@ public:
     size_t serialized_size(bool prefix) const;
     const operation::list& operations() const;
 
+    /// The serialized script without length prefix (not copied).
+    const data_chunk& bytes() const;
+
+    /// The analysis of the script bytes, computed on first call.
+    const analysis& analyze() const;
+
     // Signing.
     //-------------------------------------------------------------------------
 
+    /// The signature hash script code of a serialized subscript, with the
+    /// endorsement pushes deleted (see find_and_delete) and code separators
+    /// stripped, in one pass over the bytes.
+    static data_chunk to_script_code(data_slice subscript,
+        data_slice endorsement);
+    static data_chunk to_script_code(data_slice subscript,
+        const std::vector<data_slice>& endorsements);
+
     static hash_digest generate_signature_hash(const transaction& tx,
         uint32_t input_index, const script& script_code, uint8_t sighash_type);
 
+    /// The script code is used as provided (see to_script_code).
+    static hash_digest generate_signature_hash(const transaction& tx,
+        uint32_t input_index, data_slice script_code, uint8_t sighash_type);
+
     static bool check_signature(const ec_signature& signature,
-        uint8_t sighash_type, const data_chunk& public_key,
+        uint8_t sighash_type, data_slice public_key,
         const script& script_code, const transaction& tx,
         uint32_t input_index);
 
+    /// The script code is used as provided (see to_script_code).
+    static bool check_signature(const ec_signature& signature,
+        uint8_t sighash_type, data_slice public_key, data_slice script_code,
+        const transaction& tx, uint32_t input_index);
+
     static bool create_endorsement(endorsement& out, const ec_secret& secret,
         const script& prevout_script, const transaction& tx,
         uint32_t input_index, uint8_t sighash_type);
@@ -191,11 +242,31 @@ public:
 
     static code verify(const transaction& tx, uint32_t input, uint32_t forks);
 
+    /// Verify and record the wall time and evaluation profile to the trace.
+    static code verify(const transaction& tx, uint32_t input, uint32_t forks,
+        machine::evaluation_trace& trace);
+
     // TOD: move back to private.
     static code verify(const transaction& tx, uint32_t input_index,
         uint32_t forks, const script& input_script,
         const script& prevout_script);
 
+    /// Verify by program evaluation only, without template fast paths.
+    /// If deferred each program resolves its signature checks at its end.
+    /// If traced each program records its evaluation to the trace.
+    static code evaluate(const transaction& tx, uint32_t input_index,
+        uint32_t forks, const script& input_script,
+        const script& prevout_script, bool deferred=false,
+        machine::evaluation_trace* trace=nullptr);
+
+    /// Verify pay key hash and pay script hash multisig inputs without
+    /// program evaluation. False if not matched (result not set).
+    /// If traced the signature hashes computed are counted to the trace.
+    static bool verify_template(code& out, const transaction& tx,
+        uint32_t input_index, uint32_t forks, const script& input_script,
+        const script& prevout_script,
+        machine::evaluation_trace* trace=nullptr);
+
 protected:
     // So that input and output may call reset from their own.
     friend class input;
@@ -203,20 +274,20 @@ protected:
 
     void reset();
     bool is_pay_to_script_hash(uint32_t forks) const;
-    void find_and_delete_(const data_chunk& endorsement);
 
 private:
     static size_t serialized_size(const operation::list& ops);
     static data_chunk operations_to_data(const operation::list& ops);
 
-    operation::list& operations_move();
-    const operation::list& operations_copy() const;
+    typedef std::shared_ptr<const operation::list> operations_ptr;
+    typedef std::shared_ptr<const analysis> analysis_ptr;
 
-    // These are protected by mutex.
-    mutable operation::list operations_;
-    mutable bool cached_;
-    mutable upgrade_mutex mutex_;
+    operations_ptr operations_cache() const;
+    analysis_ptr analysis_cache() const;
 
+    // Computed lazily, published by atomic compare-exchange, then immutable.
+    mutable operations_ptr operations_;
+    mutable analysis_ptr analysis_;
     data_chunk bytes_;
     bool valid_;
 };
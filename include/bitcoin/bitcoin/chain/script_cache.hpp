@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SCRIPT_CACHE_HPP
+#define LIBBITCOIN_CHAIN_SCRIPT_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+class transaction;
+
+/// A bounded set of successful input script verifications, keyed by the
+/// transaction hash, input index and active forks. The transaction hash
+/// commits to the input scripts and previous outputs, so a verification in
+/// the transaction pool holds for the same input when connecting a block.
+/// Keys are hashed with a random salt, so entries cannot be targeted.
+/// The oldest entry is evicted when full. This class is thread safe.
+class BC_API script_cache
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<script_cache> ptr;
+
+    /// Construct with the maximum number of retained verifications.
+    script_cache(size_t capacity);
+
+    /// True if the verification has been stored (counts a hit or a miss).
+    bool contains(const transaction& tx, uint32_t input_index,
+        uint32_t forks) const;
+
+    /// Record a successful verification.
+    void store(const transaction& tx, uint32_t input_index, uint32_t forks);
+
+    /// The number of retained verifications.
+    size_t size() const;
+
+    /// The maximum number of retained verifications.
+    size_t capacity() const;
+
+    /// The number of contains queries that succeeded and that failed.
+    size_t hits() const;
+    size_t misses() const;
+
+private:
+    typedef std::unordered_set<hash_digest> entries;
+
+    hash_digest key(const transaction& tx, uint32_t input_index,
+        uint32_t forks) const;
+
+    // These are thread safe.
+    const size_t capacity_;
+    const sha256_context salted_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+
+    // These are protected by mutex.
+    entries entries_;
+    std::vector<hash_digest> order_;
+    size_t next_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SIGHASH_CACHE_HPP
+#define LIBBITCOIN_CHAIN_SIGHASH_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+class transaction;
+
+/// Precomputed signature hash invariants of a transaction.
+/// The input records and outputs are serialized once and the sha256 midstate
+/// preceding each input record is retained, so that each signature hash
+/// writes only the input's script code and the serialization that follows.
+/// This class is immutable and therefore thread safe.
+class BC_API sighash_cache
+{
+public:
+    typedef std::shared_ptr<const sighash_cache> ptr;
+
+    /// Capture the invariants of the transaction, which must not change.
+    sighash_cache(const transaction& tx);
+
+    /// Generate the (original) signature hash of the input.
+    /// The script code is serialized without prefix or code separators.
+    hash_digest hash(uint32_t input_index, data_slice script_code,
+        uint8_t sighash_type) const;
+
+private:
+    typedef std::vector<sha256_context> midstates;
+
+    void write_outputs(sha256_context& context, uint32_t input_index,
+        uint8_t sighash_type) const;
+
+    const size_t inputs_;
+    const size_t outputs_;
+    data_chunk version_;
+    data_chunk locktime_;
+
+    // Input records (point, empty script, sequence), with zeroed sequences.
+    data_chunk records_;
+    data_chunk zeroed_;
+
+    // Midstates preceding each input record, for each record serialization.
+    midstates records_midstates_;
+    midstates zeroed_midstates_;
+
+    // The serialized outputs and the offset of each within the serialization.
+    data_chunk serialized_outputs_;
+    std::vector<size_t> offsets_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -30,12 +30,15 @@
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
+#include <bitcoin/bitcoin/chain/sighash_cache.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/machine/trace_collector.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -58,6 +61,12 @@ public:
         code error = error::not_found;
         chain_state::ptr state = nullptr;
 
+        // Successful script verifications, shared with block validation.
+        script_cache::ptr scripts = nullptr;
+
+        // Profiles of input script verifications, if tracing.
+        machine::trace_collector::ptr traces = nullptr;
+
         // The transaction is an unspent duplicate.
         bool duplicate = false;
 
@@ -96,7 +105,8 @@ public:
     // Deserialization.
     //-------------------------------------------------------------------------
 
-    static transaction factory(const data_chunk& data, bool wire=true);
+    static transaction factory(const data_chunk& data, bool wire=true,
+        bool hash=false);
     static transaction factory(std::istream& stream, bool wire=true);
     static transaction factory(reader& source, bool wire=true);
 
@@ -105,7 +115,8 @@ public:
     static transaction factory(reader& source,
         const hash_digest& hash);
 
-    bool from_data(const data_chunk& data, bool wire=true);
+    /// Set hash to cache the txid from the parsed wire bytes.
+    bool from_data(const data_chunk& data, bool wire=true, bool hash=false);
     bool from_data(std::istream& stream, bool wire=true);
     bool from_data(reader& source, bool wire=true);
 
@@ -150,6 +161,9 @@ public:
     hash_digest hash() const;
     hash_digest hash(uint32_t sighash_type) const;
 
+    /// The signature hash invariants, shared by all inputs of the tx.
+    sighash_cache::ptr sighash() const;
+
     // Validation.
     //-------------------------------------------------------------------------
 
@@ -182,12 +196,24 @@ public:
     code connect(const chain_state& state) const;
     code connect_input(const chain_state& state, size_t input_index) const;
 
+    /// Skip the scripts of inputs in the cache and store those verified.
+    /// If traces is set the verification of each input is traced to it.
+    code connect(const chain_state& state, const script_cache::ptr& scripts,
+        const machine::trace_collector::ptr& traces=nullptr) const;
+    code connect_input(const chain_state& state, size_t input_index,
+        const script_cache::ptr& scripts,
+        const machine::trace_collector::ptr& traces=nullptr) const;
+
     // THIS IS FOR LIBRARY USE ONLY, DO NOT CREATE A DEPENDENCY ON IT.
     mutable validation validation;
 
 protected:
+    // So that block may cache hashes from its own wire data.
+    friend class block;
+
     void reset();
     void invalidate_cache() const;
+    void cache_hash(data_slice wire);
     bool all_inputs_final() const;
 
 private:
@@ -205,6 +231,7 @@ private:
 
     // These share a mutex as they are not expected to contend.
     mutable hash_ptr hash_;
+    mutable sighash_cache::ptr sighash_;
     mutable optional_value total_input_value_;
     mutable optional_value total_output_value_;
     mutable upgrade_mutex mutex_;
@@ -21,15 +21,18 @@
 
 #include <cstdint>
 #include <utility>
+#include <vector>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/machine/number.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/program.hpp>
+#include <bitcoin/bitcoin/machine/stack_element.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 
@@ -265,7 +268,7 @@ inline interpreter::result interpreter::op_if_dup(program& program)
 
 inline interpreter::result interpreter::op_depth(program& program)
 {
-    program.push_move(number(program.size()).data());
+    program.push(number(program.size()));
     return error::success;
 }
 
@@ -367,7 +370,7 @@ inline interpreter::result interpreter::op_size(program& program)
     auto top = program.pop();
     const auto size = top.size();
     program.push_move(std::move(top));
-    program.push_move(number(size).data());
+    program.push(number(size));
     return error::success;
 }
 
@@ -396,7 +399,7 @@ inline interpreter::result interpreter::op_add1(program& program)
         return error::op_add1;
 
     number += 1;
-    program.push_move(number.data());
+    program.push(number);
     return error::success;
 }
 
@@ -407,7 +410,7 @@ inline interpreter::result interpreter::op_sub1(program& program)
         return error::op_sub1;
 
     number -= 1;
-    program.push_move(number.data());
+    program.push(number);
     return error::success;
 }
 
@@ -418,7 +421,7 @@ inline interpreter::result interpreter::op_negate(program& program)
         return error::op_negate;
 
     number = -number;
-    program.push_move(number.data());
+    program.push(number);
     return error::success;
 }
 
@@ -431,7 +434,7 @@ inline interpreter::result interpreter::op_abs(program& program)
     if (number < 0)
         number = -number;
 
-    program.push_move(number.data());
+    program.push(number);
     return error::success;
 }
 
@@ -462,7 +465,7 @@ inline interpreter::result interpreter::op_add(program& program)
         return error::op_add;
 
     const auto result = first + second;
-    program.push_move(result.data());
+    program.push(result);
     return error::success;
 }
 
@@ -473,7 +476,7 @@ inline interpreter::result interpreter::op_sub(program& program)
         return error::op_sub;
 
     const auto result = second - first;
-    program.push_move(result.data());
+    program.push(result);
     return error::success;
 }
 
@@ -574,7 +577,7 @@ inline interpreter::result interpreter::op_min(program& program)
     if (!program.pop_binary(first, second))
         return error::op_min;
 
-    program.push_move(second < first ? second.data() : first.data());
+    program.push(second < first ? second : first);
     return error::success;
 }
 
@@ -584,7 +587,7 @@ inline interpreter::result interpreter::op_max(program& program)
     if (!program.pop_binary(first, second))
         return error::op_max;
 
-    program.push_move(second > first ? second.data() : first.data());
+    program.push(second > first ? second : first);
     return error::success;
 }
 
@@ -603,7 +606,7 @@ inline interpreter::result interpreter::op_ripemd160(program& program)
     if (program.empty())
         return error::op_ripemd160;
 
-    program.push_move(ripemd160_hash_chunk(program.pop()));
+    program.push_move(stack_element(ripemd160_hash(program.pop())));
     return error::success;
 }
 
@@ -612,7 +615,7 @@ inline interpreter::result interpreter::op_sha1(program& program)
     if (program.empty())
         return error::op_sha1;
 
-    program.push_move(sha1_hash_chunk(program.pop()));
+    program.push_move(stack_element(sha1_hash(program.pop())));
     return error::success;
 }
 
@@ -621,7 +624,7 @@ inline interpreter::result interpreter::op_sha256(program& program)
     if (program.empty())
         return error::op_sha256;
 
-    program.push_move(sha256_hash_chunk(program.pop()));
+    program.push_move(stack_element(sha256_hash(program.pop())));
     return error::success;
 }
 
@@ -630,7 +633,7 @@ inline interpreter::result interpreter::op_hash160(program& program)
     if (program.empty())
         return error::op_hash160;
 
-    program.push_move(ripemd160_hash_chunk(sha256_hash(program.pop())));
+    program.push_move(stack_element(bitcoin_short_hash(program.pop())));
     return error::success;
 }
 
@@ -639,7 +642,7 @@ inline interpreter::result interpreter::op_hash256(program& program)
     if (program.empty())
         return error::op_hash256;
 
-    program.push_move(sha256_hash_chunk(sha256_hash(program.pop())));
+    program.push_move(stack_element(bitcoin_hash(program.pop())));
     return error::success;
 }
 
@@ -650,7 +653,11 @@ inline interpreter::result interpreter::op_codeseparator(program& program,
         error::op_code_seperator;
 }
 
-inline interpreter::result interpreter::op_check_sig_verify(program& program)
+// private
+// If deferred the checked signature is assumed valid (see program::resolve),
+// as verify if the check fails evaluation and otherwise as a final checksig.
+inline interpreter::result interpreter::check_signature(program& program,
+    bool deferred, bool verify)
 {
     if (program.size() < 2)
         return error::op_check_sig_verify1;
@@ -661,12 +668,11 @@ inline interpreter::result interpreter::op_check_sig_verify(program& program)
     const auto strict = chain::script::is_enabled(program.forks(),
         rule_fork::bip66_rule);
 
-    const auto public_key = program.pop();
-    auto endorsement = program.pop();
+    auto public_key = program.pop();
+    auto endorsement = to_chunk(program.pop());
 
     // Create a subscript with endorsements stripped (sort of).
-    chain::script script_code(program.subscript());
-    script_code.find_and_delete({ endorsement });
+    const auto script_code = program.script_code(endorsement);
 
     // BIP62: An empty endorsement is not considered lax encoding.
     if (!parse_endorsement(sighash, distinguished, std::move(endorsement)))
@@ -677,14 +683,37 @@ inline interpreter::result interpreter::op_check_sig_verify(program& program)
         return strict ? error::invalid_signature_lax_encoding :
             error::invalid_signature_encoding;
 
-    return chain::script::check_signature(signature, sighash, public_key,
-        script_code, program.transaction(), program.input_index()) ?
-            error::success : error::incorrect_signature;
+    if (!public_key.empty())
+        program.trace_signature_hash();
+
+    if (!deferred || public_key.empty())
+        return chain::script::check_signature(signature, sighash, public_key,
+            script_code, program.transaction(), program.input_index()) ?
+                error::success : error::incorrect_signature;
+
+    // This always produces a valid signature hash, including one_hash.
+    program.defer_signature(chain::script::generate_signature_hash(
+        program.transaction(), program.input_index(), script_code, sighash),
+        signature, std::move(public_key), verify);
+    return error::success;
+}
+
+inline interpreter::result interpreter::op_check_sig_verify(program& program)
+{
+    return check_signature(program, program.is_deferred(), true);
 }
 
 inline interpreter::result interpreter::op_check_sig(program& program)
 {
-    const auto verified = op_check_sig_verify(program);
+    return op_check_sig(program, false);
+}
+
+// private
+// If deferred the result is pushed as if the signature check succeeds.
+inline interpreter::result interpreter::op_check_sig(program& program,
+    bool deferred)
+{
+    const auto verified = check_signature(program, deferred, false);
 
     // BIP62: only lax encoding fails the operation.
     if (verified == error::invalid_signature_lax_encoding)
@@ -704,7 +733,7 @@ inline interpreter::result interpreter::op_check_multisig_verify(
     if (!program.increment_multisig_public_key_count(key_count))
         return error::op_check_multisig_verify2;
 
-    data_stack public_keys;
+    std::vector<stack_element> public_keys;
     if (!program.pop(public_keys, key_count))
         return error::op_check_multisig_verify3;
 
@@ -715,8 +744,8 @@ inline interpreter::result interpreter::op_check_multisig_verify(
     if (signature_count < 0 || signature_count > key_count)
         return error::op_check_multisig_verify5;
 
-    data_stack endorsements;
-    if (!program.pop(endorsements, signature_count))
+    std::vector<stack_element> elements;
+    if (!program.pop(elements, signature_count))
         return error::op_check_multisig_verify6;
 
     if (program.empty())
@@ -735,16 +764,17 @@ inline interpreter::result interpreter::op_check_multisig_verify(
         rule_fork::bip66_rule);
 
     // Before looping create subscript with endorsements stripped (sort of).
-    chain::script script_code(program.subscript());
-    script_code.find_and_delete(endorsements);
+    const std::vector<data_slice> endorsements(elements.begin(),
+        elements.end());
+    const auto script_code = program.script_code(endorsements);
 
     // The exact number of signatures are required and must be in order.
     // One key can validate more than one script. So we always advance
     // until we exhaust either pubkeys (fail) or signatures (pass).
-    for (auto& endorsement: endorsements)
+    for (const auto& endorsement: elements)
     {
         // BIP62: An empty endorsement is not considered lax encoding.
-        if (!parse_endorsement(sighash, distinguished, std::move(endorsement)))
+        if (!parse_endorsement(sighash, distinguished, to_chunk(endorsement)))
             return error::invalid_signature_encoding;
 
         // Parse DER signature into an EC signature.
@@ -752,10 +782,16 @@ inline interpreter::result interpreter::op_check_multisig_verify(
             return strict ? error::invalid_signature_lax_encoding :
                 error::invalid_signature_encoding;
 
+        // The signature hash is shared by all keys tried for the endorsement.
+        const auto hash = chain::script::generate_signature_hash(
+            program.transaction(), program.input_index(), script_code,
+            sighash);
+        program.trace_signature_hash();
+
         while (true)
         {
-            if (chain::script::check_signature(signature, sighash, *public_key,
-                script_code, program.transaction(), program.input_index()))
+            if (!public_key->empty() &&
+                verify_signature(*public_key, hash, signature))
                 break;
 
             if (++public_key == public_keys.end())
@@ -869,11 +905,9 @@ inline interpreter::result interpreter::op_check_sequence_verify(
         error::op_check_sequence_verify7 : error::success;
 }
 
-// It is expected that the compiler will produce a very efficient jump table.
 inline interpreter::result interpreter::run_op(const operation& op,
     program& program)
 {
-    const auto code = op.code();
     BITCOIN_ASSERT(op.data().empty() || op.is_push());
 
     switch (op.code())
@@ -961,6 +995,46 @@ inline interpreter::result interpreter::run_op(const operation& op,
             return op_push_data(program, op.data(), max_uint16);
         case opcode::push_four_size:
             return op_push_data(program, op.data(), max_uint32);
+        case opcode::codeseparator:
+            return op_codeseparator(program, op);
+        default:
+            return run_code(op.code(), program);
+    }
+}
+
+// Push data and code separator refer to the script, all else is dispatched
+// on the operation code alone.
+inline interpreter::result interpreter::run_op(
+    const bytecode::instruction& instruction, program& program)
+{
+    BC_CONSTEXPR auto op_78 = static_cast<uint8_t>(opcode::push_four_size);
+
+    // Push sizes are validated by compilation.
+    if (static_cast<uint8_t>(instruction.code) <= op_78)
+    {
+        program.push_move(program.payload(instruction));
+        return error::success;
+    }
+
+    if (instruction.code == opcode::codeseparator)
+    {
+        program.set_jump_register(instruction);
+        return error::success;
+    }
+
+    return run_code(instruction.code, program);
+}
+
+// It is expected that the compiler will produce a very efficient jump table.
+inline interpreter::result interpreter::run_code(opcode code,
+    program& program)
+{
+    BITCOIN_ASSERT(static_cast<uint8_t>(code) >
+        static_cast<uint8_t>(opcode::push_four_size));
+    BITCOIN_ASSERT(code != opcode::codeseparator);
+
+    switch (code)
+    {
         case opcode::push_negative_1:
             return op_push_number(program, number::negative_1);
         case opcode::reserved_80:
@@ -1145,8 +1219,6 @@ inline interpreter::result interpreter::run_op(const operation& op,
             return op_hash160(program);
         case opcode::hash256:
             return op_hash256(program);
-        case opcode::codeseparator:
-            return op_codeseparator(program, op);
         case opcode::checksig:
             return op_check_sig(program);
         case opcode::checksigverify:
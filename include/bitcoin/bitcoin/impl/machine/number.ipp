@@ -34,9 +34,9 @@ static const uint64_t negative_bit = number::negative_mask;
 static const uint64_t unsigned_max_int64 = bc::max_int64;
 static const uint64_t absolute_min_int64 = bc::min_int64;
 
-inline bool is_negative(const data_chunk& data)
+inline bool is_negative(data_slice data)
 {
-    return (data.back() & number::negative_mask) != 0;
+    return (*(data.end() - 1) & number::negative_mask) != 0;
 }
 
 inline number::number()
@@ -53,7 +53,7 @@ inline number::number(int64_t value)
 //-----------------------------------------------------------------------------
 
 // The data is interpreted as little-endian.
-inline bool number::set_data(const data_chunk& data, size_t max_size)
+inline bool number::set_data(data_slice data, size_t max_size)
 {
     if (data.size() > max_size)
         return false;
@@ -65,7 +65,7 @@ inline bool number::set_data(const data_chunk& data, size_t max_size)
 
     // This is "from little endian" with a variable buffer.
     for (size_t i = 0; i != data.size(); ++i)
-        value_ |= static_cast<int64_t>(data[i]) << (8 * i);
+        value_ |= static_cast<int64_t>(data.data()[i]) << (8 * i);
 
     if (is_negative(data))
     {
@@ -79,41 +79,49 @@ inline bool number::set_data(const data_chunk& data, size_t max_size)
 
 // The result is little-endian.
 inline data_chunk number::data() const
+{
+    encoding buffer;
+    const auto size = data(buffer);
+    return data_chunk(buffer.begin(), buffer.begin() + size);
+}
+
+// The result is little-endian.
+inline size_t number::data(encoding& out) const
 {
     if (value_ == 0)
-        return{};
+        return 0;
 
-    data_chunk data;
+    size_t size = 0;
     const bool set_negative = value_ < 0;
     uint64_t absolute = set_negative ? -value_ : value_;
 
     // This is "to little endian" with a minimal buffer.
     while (absolute != 0)
     {
-        data.push_back(static_cast<uint8_t>(absolute));
+        out[size++] = static_cast<uint8_t>(absolute);
         absolute >>= 8;
     }
 
-    const auto negative_bit_set = is_negative(data);
+    const auto negative_bit_set = (out[size - 1] & number::negative_mask) != 0;
 
     // If the most significant byte is >= 0x80 and the value is negative,
     // push a new 0x80 byte that will be popped off when converting to
     // an integral.
     if (negative_bit_set && set_negative)
-        data.push_back(number::negative_mask);
+        out[size++] = number::negative_mask;
 
     // If the most significant byte is >= 0x80 and the value is positive,
     // push a new zero-byte to make the significant byte < 0x80 again.
     else if (negative_bit_set)
-        data.push_back(0);
+        out[size++] = 0;
 
     // If the most significant byte is < 0x80 and the value is negative,
     // add 0x80 to it, since it will be subtracted and interpreted as
     // a negative when converting to an integral.
     else if (set_negative)
-        data.back() |= number::negative_mask;
+        out[size - 1] |= number::negative_mask;
 
-    return data;
+    return size;
 }
 
 inline int32_t number::int32() const
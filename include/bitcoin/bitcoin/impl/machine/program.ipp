@@ -22,11 +22,18 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
+#include <vector>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
 #include <bitcoin/bitcoin/machine/number.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/machine/stack_element.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 
@@ -39,7 +46,7 @@ namespace machine {
 inline bool program::is_valid() const
 {
     // An invalid sequence indicates a failure deserializing operations.
-    return script_.is_valid_operations() && !script_.is_unspendable();
+    return bytecode_->is_valid() && !script_.is_unspendable();
 }
 
 inline uint32_t program::forks() const
@@ -52,11 +59,26 @@ inline uint32_t program::input_index() const
     return input_index_;
 }
 
+inline bool program::is_deferred() const
+{
+    return deferred_;
+}
+
+inline bool program::is_traced() const
+{
+    return trace_ != nullptr;
+}
+
 inline const chain::transaction& program::transaction() const
 {
     return transaction_;
 }
 
+inline const bytecode& program::compiled() const
+{
+    return *bytecode_;
+}
+
 // Program registers.
 //-----------------------------------------------------------------------------
 
@@ -65,14 +87,15 @@ inline program::op_iterator program::begin() const
     return script_.begin();
 }
 
-inline program::op_iterator program::jump() const
+inline program::op_iterator program::end() const
 {
-    return jump_;
+    return script_.end();
 }
 
-inline program::op_iterator program::end() const
+// The offset of the subscript within the serialized script.
+inline size_t program::jump() const
 {
-    return script_.end();
+    return jump_;
 }
 
 inline size_t program::operation_count() const
@@ -88,15 +111,20 @@ inline bool operation_overflow(size_t count)
     return count > max_counted_ops;
 }
 
-inline bool program::increment_operation_count(const operation& op)
+inline bool program::increment_operation_count(opcode code)
 {
     // Addition is safe due to script size validation.
-    if (operation::is_counted(op.code()))
+    if (operation::is_counted(code))
         ++operation_count_;
 
     return !operation_overflow(operation_count_);
 }
 
+inline bool program::increment_operation_count(const operation& op)
+{
+    return increment_operation_count(op.code());
+}
+
 inline bool program::increment_multisig_public_key_count(int32_t count)
 {
     // bit.ly/2d1bsdB
@@ -118,21 +146,70 @@ inline bool program::set_jump_register(const operation& op, int32_t offset)
         return &operation == &op;
     };
 
-    // This is not efficient but is simplifying and subscript is rarely used.
-    // Otherwise we must track the program counter through each evaluation.
-    jump_ = std::find_if(script_.begin(), script_.end(), finder);
+    // This is not efficient but is only used to run individual operations.
+    // Script evaluation sets the register from the compiled instruction.
+    const auto it = std::find_if(script_.begin(), script_.end(), finder);
 
-    if (jump_ == script_.end())
+    if (it == script_.end())
         return false;
 
     // This does not require guard because op_codeseparator can only increment.
     // Even if the opcode is last in the sequnce the increment is valid (end).
     BITCOIN_ASSERT_MSG(offset == 1, "unguarded jump offset");
 
-    jump_ += offset;
+    const auto jump = it + offset;
+    jump_ = 0;
+
+    for (auto op = script_.begin(); op != jump; ++op)
+        jump_ += op->serialized_size();
+
     return true;
 }
 
+inline void program::set_jump_register(
+    const bytecode::instruction& instruction)
+{
+    // The subscript begins after the instruction (and any push data).
+    jump_ = instruction.offset + instruction.size;
+}
+
+// The push data of a payload instruction, copied from the script.
+inline program::value_type program::payload(
+    const bytecode::instruction& instruction) const
+{
+    const auto& bytes = script_.bytes();
+    BITCOIN_ASSERT(instruction.offset + instruction.size <= bytes.size());
+    const auto begin = bytes.data() + instruction.offset;
+    return value_type(begin, begin + instruction.size);
+}
+
+inline void program::defer_signature(const hash_digest& sighash,
+    const ec_signature& signature, value_type&& public_key, bool verify)
+{
+    BITCOIN_ASSERT(deferred_);
+    signatures_.push_back({ sighash, signature, std::move(public_key),
+        verify });
+}
+
+// Tracing.
+//-----------------------------------------------------------------------------
+
+inline void program::trace_operation(opcode code)
+{
+    if (trace_ == nullptr)
+        return;
+
+    ++trace_->operations[static_cast<uint8_t>(code)];
+    trace_->stack_high_water = std::max(trace_->stack_high_water,
+        size() + alternate_.size());
+}
+
+inline void program::trace_signature_hash()
+{
+    if (trace_ != nullptr)
+        ++trace_->signature_hashes;
+}
+
 // Primary stack (push).
 //-----------------------------------------------------------------------------
 
@@ -142,6 +219,14 @@ inline void program::push(bool value)
     push_move(value ? value_type{ number::positive_1 } : value_type{});
 }
 
+// The number is encoded directly into the element, without a data_chunk.
+inline void program::push(const number& value)
+{
+    number::encoding buffer;
+    const auto begin = buffer.data();
+    push_move(value_type(begin, begin + value.data(buffer)));
+}
+
 // Be explicit about the intent to move or copy, to get compiler help.
 inline void program::push_move(value_type&& item)
 {
@@ -158,10 +243,10 @@ inline void program::push_copy(const value_type& item)
 //-----------------------------------------------------------------------------
 
 // This must be guarded.
-inline data_chunk program::pop()
+inline program::value_type program::pop()
 {
     BITCOIN_ASSERT(!empty());
-    const auto value = primary_.back();
+    auto value = std::move(primary_.back());
     primary_.pop_back();
     return value;
 }
@@ -176,9 +261,15 @@ inline bool program::pop(int32_t& out_value)
     return true;
 }
 
+// The number is decoded in place, so the element is not moved out.
 inline bool program::pop(number& out_number, size_t maxiumum_size)
 {
-    return !empty() && out_number.set_data(pop(), maxiumum_size);
+    if (empty())
+        return false;
+
+    const auto result = out_number.set_data(primary_.back(), maxiumum_size);
+    primary_.pop_back();
+    return result;
 }
 
 inline bool program::pop_binary(number& first, number& second)
@@ -215,7 +306,7 @@ inline bool program::pop_position(stack_iterator& out_position)
 }
 
 // pop1/pop2/.../pop[count]
-inline bool program::pop(data_stack& section, size_t count)
+inline bool program::pop(stack& section, size_t count)
 {
     if (size() < count)
         return false;
@@ -240,8 +331,8 @@ inline void program::swap(size_t index_left, size_t index_right)
 {
     // TODO: refactor to allow DRY without const_cast here.
     std::swap(
-        const_cast<data_stack::value_type&>(item(index_left)),
-        const_cast<data_stack::value_type&>(item(index_right)));
+        const_cast<value_type&>(item(index_left)),
+        const_cast<value_type&>(item(index_right)));
 }
 
 // pop1/pop2/.../pop[pos-1]/pop[pos]/push[pos-1]/.../push2/push1
@@ -299,13 +390,18 @@ inline bool program::is_stack_overflow() const
     return size() + alternate_.size() > max_stack_size;
 }
 
-inline bool program::if_(const operation& op) const
+inline bool program::if_(opcode code) const
 {
     // Skip operation if failed and the operator is unconditional.
-    return op.is_conditional() || succeeded();
+    return operation::is_conditional(code) || succeeded();
+}
+
+inline bool program::if_(const operation& op) const
+{
+    return if_(op.code());
 }
 
-inline const data_stack::value_type& program::item(size_t index) /*const*/
+inline const program::value_type& program::item(size_t index) /*const*/
 {
     return *position(index);
 }
@@ -322,15 +418,33 @@ inline program::stack_iterator program::position(size_t index) /*const*/
     return (primary_.end() - 1) - index;
 }
 
+// This is the serialized script from the jump register to the end.
+inline data_slice program::subscript_data() const
+{
+    const auto& bytes = script_.bytes();
+    BITCOIN_ASSERT(jump_ <= bytes.size());
+    return data_slice(bytes.data() + jump_, bytes.data() + bytes.size());
+}
+
 // Pop jump-to-end, push all back, use to construct a script.
-inline operation::list program::subscript() const
+// Operations serialize to their original bytes, so the subscript is copied
+// from the script without decoding.
+inline chain::script program::subscript() const
 {
-    operation::list ops;
+    return chain::script(to_chunk(subscript_data()), false);
+}
 
-    for (auto op = jump(); op != end(); ++op)
-        ops.push_back(*op);
+// The subscript with the endorsement deleted and code separators stripped.
+inline data_chunk program::script_code(data_slice endorsement) const
+{
+    return chain::script::to_script_code(subscript_data(), endorsement);
+}
 
-    return ops;
+// The subscript with the endorsements deleted and code separators stripped.
+inline data_chunk program::script_code(
+    const std::vector<data_slice>& endorsements) const
+{
+    return chain::script::to_script_code(subscript_data(), endorsements);
 }
 
 inline size_t program::size() const
@@ -355,7 +469,7 @@ inline void program::push_alternate(value_type&& value)
 inline program::value_type program::pop_alternate()
 {
     BITCOIN_ASSERT(!alternate_.empty());
-    const auto value = alternate_.back();
+    auto value = std::move(alternate_.back());
     alternate_.pop_back();
     return value;
 }
@@ -0,0 +1,216 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_STACK_ELEMENT_IPP
+#define LIBBITCOIN_MACHINE_STACK_ELEMENT_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+inline stack_element::stack_element()
+  : size_(0)
+{
+}
+
+inline stack_element::stack_element(data_slice data)
+  : size_(0)
+{
+    assign(data.begin(), data.end());
+}
+
+inline stack_element::stack_element(const data_chunk& data)
+  : size_(0)
+{
+    assign(data.data(), data.data() + data.size());
+}
+
+inline stack_element::stack_element(std::initializer_list<uint8_t> data)
+  : size_(0)
+{
+    assign(data.begin(), data.end());
+}
+
+inline stack_element::stack_element(const uint8_t* begin, const uint8_t* end)
+  : size_(0)
+{
+    assign(begin, end);
+}
+
+inline stack_element::stack_element(stack_element&& other) BC_NOEXCEPT
+  : size_(other.size_)
+{
+    if (other.is_inline())
+    {
+        std::memcpy(buffer_, other.buffer_, size_);
+        return;
+    }
+
+    // Take ownership of the heap allocation.
+    heap_ = other.heap_;
+    other.size_ = 0;
+}
+
+inline stack_element::stack_element(const stack_element& other)
+  : size_(0)
+{
+    assign(other.begin(), other.end());
+}
+
+inline stack_element::~stack_element()
+{
+    release();
+}
+
+// Operators.
+//-----------------------------------------------------------------------------
+
+inline stack_element& stack_element::operator=(
+    stack_element&& other) BC_NOEXCEPT
+{
+    if (this == &other)
+        return *this;
+
+    release();
+    size_ = other.size_;
+
+    if (other.is_inline())
+    {
+        std::memcpy(buffer_, other.buffer_, size_);
+        return *this;
+    }
+
+    // Take ownership of the heap allocation.
+    heap_ = other.heap_;
+    other.size_ = 0;
+    return *this;
+}
+
+inline stack_element& stack_element::operator=(const stack_element& other)
+{
+    if (this != &other)
+    {
+        release();
+        assign(other.begin(), other.end());
+    }
+
+    return *this;
+}
+
+inline bool stack_element::operator==(const stack_element& other) const
+{
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+inline bool stack_element::operator!=(const stack_element& other) const
+{
+    return !(*this == other);
+}
+
+inline uint8_t stack_element::operator[](size_t index) const
+{
+    BITCOIN_ASSERT(index < size_);
+    return data()[index];
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+inline bool stack_element::is_inline() const
+{
+    return size_ <= inline_capacity;
+}
+
+inline const uint8_t* stack_element::data() const
+{
+    return is_inline() ? buffer_ : heap_;
+}
+
+inline stack_element::const_iterator stack_element::begin() const
+{
+    return data();
+}
+
+inline stack_element::const_iterator stack_element::end() const
+{
+    return data() + size_;
+}
+
+// This must be guarded.
+inline uint8_t stack_element::front() const
+{
+    BITCOIN_ASSERT(!empty());
+    return data()[0];
+}
+
+// This must be guarded.
+inline uint8_t stack_element::back() const
+{
+    BITCOIN_ASSERT(!empty());
+    return data()[size_ - 1];
+}
+
+inline size_t stack_element::size() const
+{
+    return size_;
+}
+
+inline bool stack_element::empty() const
+{
+    return size_ == 0;
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+// This must be called only when empty.
+inline void stack_element::assign(const uint8_t* begin, const uint8_t* end)
+{
+    BITCOIN_ASSERT(size_ == 0 && begin <= end);
+    size_ = static_cast<uint32_t>(end - begin);
+
+    if (!is_inline())
+        heap_ = new uint8_t[size_];
+
+    // A null source is valid for an empty range, but not for memcpy.
+    if (size_ != 0)
+        std::memcpy(is_inline() ? buffer_ : heap_, begin, size_);
+}
+
+inline void stack_element::release()
+{
+    if (!is_inline())
+        delete[] heap_;
+
+    size_ = 0;
+}
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
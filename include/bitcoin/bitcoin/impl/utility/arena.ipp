@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ARENA_IPP
+#define LIBBITCOIN_ARENA_IPP
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace libbitcoin {
+
+template <typename Type>
+arena_allocator<Type>::arena_allocator(arena& region)
+  : region_(&region)
+{
+}
+
+template <typename Type>
+template <typename Other>
+arena_allocator<Type>::arena_allocator(const arena_allocator<Other>& other)
+  : region_(other.region())
+{
+}
+
+template <typename Type>
+Type* arena_allocator<Type>::allocate(size_t count)
+{
+    if (count > std::numeric_limits<size_t>::max() / sizeof(Type))
+        throw std::bad_alloc();
+
+    const auto memory = region_->allocate(count * sizeof(Type),
+        alignof(Type));
+
+    return static_cast<Type*>(memory);
+}
+
+// Memory is returned to the heap only when the arena is released.
+template <typename Type>
+void arena_allocator<Type>::deallocate(Type*, size_t)
+{
+}
+
+template <typename Type>
+arena* arena_allocator<Type>::region() const
+{
+    return region_;
+}
+
+template <typename Left, typename Right>
+bool operator==(const arena_allocator<Left>& left,
+    const arena_allocator<Right>& right)
+{
+    return left.region() == right.region();
+}
+
+template <typename Left, typename Right>
+bool operator!=(const arena_allocator<Left>& left,
+    const arena_allocator<Right>& right)
+{
+    return !(left == right);
+}
+
+} // namespace libbitcoin
+
+#endif
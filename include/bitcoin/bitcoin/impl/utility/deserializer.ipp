@@ -33,14 +33,14 @@ namespace libbitcoin {
 // Since the end is not used just use begin.
 template <typename Iterator, bool CheckSafe>
 deserializer<Iterator, CheckSafe>::deserializer(const Iterator begin)
-  : iterator_(begin), end_(begin), valid_(true)
+  : valid_(true), iterator_(begin), end_(begin)
 {
 }
 
 template <typename Iterator, bool CheckSafe>
 deserializer<Iterator, CheckSafe>::deserializer(const Iterator begin,
     const Iterator end)
-  : iterator_(begin), end_(end), valid_(true)
+  : valid_(true), iterator_(begin), end_(end)
 {
 }
 
@@ -232,20 +232,16 @@ data_chunk deserializer<Iterator, CheckSafe>::read_bytes()
 template <typename Iterator, bool CheckSafe>
 data_chunk deserializer<Iterator, CheckSafe>::read_bytes(size_t size)
 {
-    // TODO: avoid unnecessary default zero fill using
-    // the allocator adapter here: stackoverflow.com/a/21028912/1172329.
-    data_chunk out(size);
-
+    // Construct from the range, avoiding a redundant zero fill.
     if (!safe(size))
         invalidate();
 
-    if (!valid_ || size == 0)
-        return out;
+    if (!valid_)
+        return data_chunk(size);
 
     const auto begin = iterator_;
     iterator_ += size;
-    std::copy_n(begin, size, out.begin());
-    return out;
+    return data_chunk(begin, iterator_);
 }
 
 template <typename Iterator, bool CheckSafe>
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_BYTECODE_HPP
+#define LIBBITCOIN_MACHINE_BYTECODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/machine/script_pattern.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+/// A script compiled to a compact instruction stream for the interpreter.
+/// Push data is referenced by offset into the serialized script so that
+/// compilation does not allocate per push, and push sizes and disabled codes
+/// are validated once here instead of at each step of evaluation.
+class BC_API bytecode
+{
+public:
+    struct instruction
+    {
+        /// The operation code.
+        opcode code;
+
+        /// The offset of the operation code within the script.
+        uint32_t position;
+
+        /// The offset and size of the push data within the script.
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    typedef std::vector<instruction> list;
+    typedef std::shared_ptr<const bytecode> ptr;
+
+    /// Compile the serialized script (without length prefix).
+    /// Standard output templates return a shared (memoized) instance.
+    static ptr compile(const data_chunk& script);
+
+    /// Read the operation at position (which must be within the script),
+    /// advancing position to its push data (if any). False if the push is
+    /// truncated or oversized, as with operation deserialization.
+    static bool read(opcode& out_code, size_t& out_size, size_t& position,
+        data_slice script);
+
+    // Constructors.
+    //-------------------------------------------------------------------------
+
+    bytecode();
+    bytecode(const data_chunk& script,
+        script_pattern pattern=script_pattern::non_standard);
+
+    // Properties.
+    //-------------------------------------------------------------------------
+
+    /// False if a push is truncated or oversized (script not parseable).
+    bool is_valid() const;
+
+    /// True if instructions end at a disabled operation code.
+    bool is_disabled() const;
+
+    /// The instructions, ending before any disabled operation code.
+    const list& instructions() const;
+
+    /// The standard output pattern of a memoized instance, otherwise
+    /// non_standard (which does not imply the script is non-standard).
+    script_pattern pattern() const;
+
+private:
+    list instructions_;
+    script_pattern pattern_;
+    bool valid_;
+    bool disabled_;
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
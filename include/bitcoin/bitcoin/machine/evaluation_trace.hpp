@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_EVALUATION_TRACE_HPP
+#define LIBBITCOIN_MACHINE_EVALUATION_TRACE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+/// The profile of the script verification of one input.
+/// Evaluation is traced only when a trace is provided, so an untraced
+/// verification incurs no cost.
+struct evaluation_trace
+{
+    typedef std::vector<evaluation_trace> list;
+
+    /// The number of executed operations by opcode value.
+    typedef std::array<uint32_t, 256> histogram;
+
+    /// The input (transaction hash and input index).
+    hash_digest hash = null_hash;
+    uint32_t index = 0;
+
+    /// The wall time of the verification.
+    asio::duration duration = asio::duration::zero();
+
+    /// The input was verified by a template fast path, not evaluation.
+    bool templated = false;
+
+    /// Operations executed, excluding those in unexecuted branches.
+    histogram operations = {};
+
+    /// The largest combined size of the primary and alternate stacks.
+    size_t stack_high_water = 0;
+
+    /// The number of signature hashes computed.
+    size_t signature_hashes = 0;
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/program.hpp>
@@ -110,7 +111,8 @@ public:
     static result op_check_locktime_verify(program& program);
     static result op_check_sequence_verify(program& program);
 
-    /// Run program script.
+    /// Run program script, then resolve any deferred signature checks.
+    /// A traced program records each executed operation to its trace.
     static code run(program& program);
 
     /// Run individual operations (idependent of the script).
@@ -118,7 +120,15 @@ public:
     static code run(const operation& op, program& program);
 
 private:
+    static result check_signature(program& program, bool deferred,
+        bool verify);
+    static result op_check_sig(program& program, bool deferred);
+    template <bool Traced>
+    static code run_program(program& program);
     static result run_op(const operation& op, program& program);
+    static result run_op(const bytecode::instruction& instruction,
+        program& program);
+    static result run_code(opcode code, program& program);
 };
 
 } // namespace machine
@@ -61,6 +61,9 @@ public:
     static const uint8_t positive_16;
     static const uint8_t negative_mask;
 
+    /// A buffer of the maximum byte length of any value.
+    typedef byte_array<9> encoding;
+
     /// Construct with zero value.
     number();
 
@@ -68,7 +71,7 @@ public:
     explicit number(int64_t value);
 
     /// Replace the value derived from a byte vector with LSB first ordering.
-    bool set_data(const data_chunk& data, size_t max_size);
+    bool set_data(data_slice data, size_t max_size);
 
     // Properties
     //-------------------------------------------------------------------------
@@ -76,6 +79,9 @@ public:
     /// Return the value as a byte vector with LSB first ordering.
     data_chunk data() const;
 
+    /// Write the value with LSB first ordering, returning the byte length.
+    size_t data(encoding& out) const;
+
     /// Return the value bounded by the limits of int32.
     int32_t int32() const;
 
@@ -20,13 +20,20 @@
 #define LIBBITCOIN_MACHINE_PROGRAM_HPP
 
 #include <cstdint>
+#include <vector>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
 #include <bitcoin/bitcoin/machine/number.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/machine/stack_element.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 
 namespace libbitcoin {
@@ -35,14 +42,26 @@ namespace machine {
 class BC_API program
 {
 public:
-    typedef data_stack::value_type value_type;
+    typedef stack_element value_type;
+    typedef std::vector<value_type> stack;
     typedef operation::iterator op_iterator;
 
     // Older libstdc++ does not allow erase with const iterator.
     // This is a bug that requires we up the minimum compiler version.
     // So presently stack_iterator is a non-const iterator.
-    ////typedef data_stack::const_iterator stack_iterator;
-    typedef data_stack::iterator stack_iterator;
+    ////typedef stack::const_iterator stack_iterator;
+    typedef stack::iterator stack_iterator;
+
+    /// A signature check deferred to the end of evaluation (see resolve).
+    /// A failed verify check fails evaluation, otherwise the check is of the
+    /// final checksig and its (top stack) result is replaced with false.
+    struct deferred_signature
+    {
+        hash_digest sighash;
+        ec_signature signature;
+        value_type public_key;
+        bool verify;
+    };
 
     /// Create an instance that does not expect to verify signatures.
     /// This is useful for script utilities but not with input validation.
@@ -55,50 +74,73 @@ public:
     program(const chain::script& script);
 
     /// Create an instance with empty stacks (input run).
+    /// If deferred the signature checks of checksigverify and of a final
+    /// checksig are resolved together at the end of evaluation.
+    /// If traced evaluation is recorded to the trace, which must outlive it.
     program(const chain::script& script, const chain::transaction& transaction,
-        uint32_t input_index, uint32_t forks);
+        uint32_t input_index, uint32_t forks, bool deferred=false,
+        evaluation_trace* trace=nullptr);
 
-    /// Create using copied forks and copied stack (prevout run).
+    /// Create using copied forks, mode, trace and copied stack (prevout run).
     program(const chain::script& script, const program& other);
 
-    /// Create using copied forks and moved stack (p2sh run).
+    /// Create using copied forks, mode, trace and moved stack (p2sh run).
     program(const chain::script& script, program&& other, bool move);
 
+    /// Return the stacks to the thread's arena for reuse.
+    ~program();
+
     /// Constant registers.
     bool is_valid() const;
     uint32_t forks() const;
     uint32_t input_index() const;
+    bool is_deferred() const;
+    bool is_traced() const;
     const chain::transaction& transaction() const;
+    const bytecode& compiled() const;
 
     /// Program registers.
     op_iterator begin() const;
-    op_iterator jump() const;
     op_iterator end() const;
+    size_t jump() const;
     size_t operation_count() const;
 
     /// Instructions.
     code evaluate();
     code evaluate(const operation& op);
+    bool increment_operation_count(opcode code);
     bool increment_operation_count(const operation& op);
     bool increment_multisig_public_key_count(int32_t count);
     bool set_jump_register(const operation& op, int32_t offset);
+    void set_jump_register(const bytecode::instruction& instruction);
+    value_type payload(const bytecode::instruction& instruction) const;
+
+    /// Deferred signature checks.
+    void defer_signature(const hash_digest& sighash,
+        const ec_signature& signature, value_type&& public_key, bool verify);
+    code resolve(const code& result);
+
+    /// Tracing (ignored if not traced).
+    void trace_operation(opcode code);
+    void trace_signature_hash();
 
     // Primary stack.
     //-------------------------------------------------------------------------
 
     /// Primary push.
     void push(bool value);
+    void push(const number& value);
     void push_move(value_type&& item);
     void push_copy(const value_type& item);
 
     /// Primary pop.
-    data_chunk pop();
+    value_type pop();
     bool pop(int32_t& out_value);
     bool pop(number& out_number, size_t maxiumum_size=max_number_size);
     bool pop_binary(number& first, number& second);
     bool pop_ternary(number& first, number& second, number& third);
     bool pop_position(stack_iterator& out_position);
-    bool pop(data_stack& section, size_t count);
+    bool pop(stack& section, size_t count);
 
     /// Primary push/pop optimizations (active).
     void duplicate(size_t index);
@@ -111,11 +153,14 @@ public:
     bool stack_true() const;
     bool stack_result() const;
     bool is_stack_overflow() const;
+    bool if_(opcode code) const;
     bool if_(const operation& op) const;
     const value_type& item(size_t index) /*const*/;
     bool top(number& out_number, size_t maxiumum_size=max_number_size) /*const*/;
     stack_iterator position(size_t index) /*const*/;
-    operation::list subscript() const;
+    chain::script subscript() const;
+    data_chunk script_code(data_slice endorsement) const;
+    data_chunk script_code(const std::vector<data_slice>& endorsements) const;
     size_t size() const;
 
     // Alternate stack.
@@ -138,20 +183,24 @@ private:
     // A space-efficient dynamic bitset (specialized).
     typedef std::vector<bool> bool_stack;
 
-    void reserve_stacks();
     bool stack_to_bool() const;
+    data_slice subscript_data() const;
 
     const chain::script& script_;
     const chain::transaction& transaction_;
     const uint32_t input_index_;
     const uint32_t forks_;
+    const bool deferred_;
+    evaluation_trace* const trace_;
+    const bytecode::ptr bytecode_;
 
     size_t negative_count_;
     size_t operation_count_;
-    op_iterator jump_;
-    data_stack primary_;
-    data_stack alternate_;
+    size_t jump_;
+    stack primary_;
+    stack alternate_;
     bool_stack condition_;
+    std::vector<deferred_signature> signatures_;
 };
 
 } // namespace machine
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_STACK_ELEMENT_HPP
+#define LIBBITCOIN_MACHINE_STACK_ELEMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <bitcoin/bitcoin/compat.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+/// A byte vector for the script stacks, with inline storage sufficient for
+/// keys, signatures, hashes and numbers. Only larger pushes (such as p2sh
+/// redeem scripts) allocate. Elements are immutable once constructed.
+class BC_API stack_element
+{
+public:
+    typedef uint8_t value_type;
+    typedef const uint8_t* iterator;
+    typedef const uint8_t* const_iterator;
+
+    /// Sufficient for an uncompressed key or a maximal endorsement.
+    static BC_CONSTEXPR size_t inline_capacity = 80;
+
+    // Constructors.
+    //-------------------------------------------------------------------------
+
+    stack_element();
+    stack_element(data_slice data);
+    stack_element(const data_chunk& data);
+    stack_element(std::initializer_list<uint8_t> data);
+    stack_element(const uint8_t* begin, const uint8_t* end);
+    stack_element(stack_element&& other) BC_NOEXCEPT;
+    stack_element(const stack_element& other);
+    ~stack_element();
+
+    // Operators.
+    //-------------------------------------------------------------------------
+
+    stack_element& operator=(stack_element&& other) BC_NOEXCEPT;
+    stack_element& operator=(const stack_element& other);
+
+    bool operator==(const stack_element& other) const;
+    bool operator!=(const stack_element& other) const;
+    uint8_t operator[](size_t index) const;
+
+    // Properties.
+    //-------------------------------------------------------------------------
+
+    /// True if the data is held in the inline buffer.
+    bool is_inline() const;
+
+    const uint8_t* data() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    uint8_t front() const;
+    uint8_t back() const;
+    size_t size() const;
+    bool empty() const;
+
+private:
+    void assign(const uint8_t* begin, const uint8_t* end);
+    void release();
+
+    uint32_t size_;
+
+    union
+    {
+        uint8_t buffer_[inline_capacity];
+        uint8_t* heap_;
+    };
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/machine/stack_element.ipp>
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_TRACE_COLLECTOR_HPP
+#define LIBBITCOIN_MACHINE_TRACE_COLLECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+/// Aggregates the evaluation traces of a set of inputs (such as a block),
+/// retaining the traces of the slowest inputs. This class is thread safe.
+class BC_API trace_collector
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<trace_collector> ptr;
+
+    /// Construct to retain the traces of the given number of slowest inputs.
+    trace_collector(size_t worst);
+
+    /// Aggregate the trace of an input.
+    void collect(const evaluation_trace& trace);
+
+    /// Clear all traces and totals.
+    void clear();
+
+    /// The number of inputs collected and of those verified by template.
+    size_t inputs() const;
+    size_t templated() const;
+
+    /// The total wall time of all input verifications.
+    asio::duration duration() const;
+
+    /// The total number of executed operations by opcode value.
+    evaluation_trace::histogram operations() const;
+
+    /// The largest stack high-water mark of all inputs.
+    size_t stack_high_water() const;
+
+    /// The total number of signature hashes computed.
+    size_t signature_hashes() const;
+
+    /// The traces of the slowest inputs, slowest first.
+    evaluation_trace::list worst() const;
+
+    /// Emit the totals and the slowest input times to statsd, with metric
+    /// names prefixed by the given prefix (e.g. "block.scripts").
+    void report(const std::string& prefix) const;
+
+private:
+    // These are protected by mutex.
+    const size_t worst_;
+    size_t inputs_;
+    size_t templated_;
+    asio::duration duration_;
+    evaluation_trace::histogram operations_;
+    size_t stack_high_water_;
+    size_t signature_hashes_;
+    evaluation_trace::list slowest_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
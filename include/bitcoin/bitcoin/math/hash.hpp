@@ -20,6 +20,7 @@
 #define LIBBITCOIN_HASH_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <boost/functional/hash_fwd.hpp>
@@ -124,6 +125,20 @@ BC_API data_chunk scrypt(data_slice data, data_slice salt, uint64_t N,
 /// Generate a bitcoin hash.
 BC_API hash_digest bitcoin_hash(data_slice data);
 
+/// Generate bitcoin hashes of count consecutive 64 byte messages, writing
+/// count consecutive 32 byte digests. Messages are hashed in parallel lanes
+/// where the cpu supports it. The output may overlap the input, as when
+/// reducing a level of a merkle tree in place.
+BC_API void bitcoin_hash_64(uint8_t* out, const uint8_t* in, size_t count);
+
+/// Generate the merkle root of the hashes, null_hash if there are none.
+/// Each tree level is reduced in place, duplicating an odd last hash.
+BC_API hash_digest merkle_root(const hash_list& hashes);
+
+/// Generate the merkle branch of the indexed hash, the sibling at each
+/// level from the leaf toward the root. Empty if the index is out of range.
+BC_API hash_list merkle_branch(const hash_list& hashes, size_t index);
+
 /// Generate a bitcoin short hash.
 BC_API short_hash bitcoin_short_hash(data_slice data);
 
@@ -156,6 +171,24 @@ BC_API long_hash hmac_sha512_hash(data_slice data, data_slice key);
 BC_API long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
     data_slice salt, size_t iterations);
 
+/// Incremental sha256 hashing, copy the instance to capture a midstate.
+class BC_API sha256_context
+{
+public:
+    sha256_context();
+
+    /// Append data to the message.
+    void write(data_slice data);
+
+    /// Generate the sha256 hash of the message written to this point.
+    hash_digest finalize() const;
+
+private:
+    uint32_t state_[8];
+    uint32_t count_[2];
+    uint8_t buffer_[64];
+};
+
 } // namespace libbitcoin
 
 // Extend std and boost namespaces with our hash wrappers.
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SIGNATURE_BATCH_HPP
+#define LIBBITCOIN_SIGNATURE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+
+namespace libbitcoin {
+
+/// A collection of (point, hash, signature) triples verified in bulk.
+/// Items are collected on one thread and verified either on the calling
+/// thread or across a threadpool, with a result retained for each item.
+/// This class is not thread safe.
+class BC_API signature_batch
+{
+public:
+    /// Add an item to the batch, returning its index for the result.
+    size_t push(data_slice point, const hash_digest& hash,
+        const ec_signature& signature);
+
+    size_t size() const;
+    bool empty() const;
+    void reserve(size_t size);
+    void clear();
+
+    /// Verify all items on the calling thread, true if all are valid.
+    bool verify();
+
+    /// Verify all items using the threadpool and the calling thread.
+    bool verify(dispatcher& dispatch);
+
+    /// The result of the indexed item, false if invalid or unverified.
+    bool is_valid(size_t index) const;
+
+private:
+    struct item
+    {
+        ec_uncompressed point;
+        uint8_t point_size;
+        hash_digest hash;
+        ec_signature signature;
+        bool valid;
+    };
+
+    bool verify(size_t first, size_t last);
+
+    std::vector<item> items_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -22,6 +22,7 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <vector>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/chain/block.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
@@ -49,6 +50,11 @@ public:
     merkle_block(chain::header&& header, size_t total_transactions,
         hash_list&& hashes, data_chunk&& flags);
     merkle_block(const chain::block& block);
+
+    /// Construct the bip37 partial merkle tree of the block, proving the
+    /// transactions for which matches is set (missing entries are unset).
+    merkle_block(const chain::block& block, const std::vector<bool>& matches);
+
     merkle_block(const merkle_block& other);
     merkle_block(merkle_block&& other);
 
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ARENA_HPP
+#define LIBBITCOIN_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+
+/// This class is not thread safe.
+/// A monotonic region allocator, memory is only returned on release or
+/// destruction. Use to back short-lived, block-scoped containers so that
+/// their nodes share a few large allocations and are freed together.
+class BC_API arena
+  : noncopyable
+{
+public:
+    static const size_t default_block_size;
+
+    /// Reserve the first region lazily, growing by block_size.
+    arena(size_t block_size=default_block_size);
+
+    /// Allocate size bytes aligned to alignment (a power of two).
+    void* allocate(size_t size, size_t alignment);
+
+    /// Free all regions, invalidating all prior allocations.
+    void release();
+
+    /// The total number of bytes reserved from the heap.
+    size_t reserved() const;
+
+private:
+    typedef std::unique_ptr<char[]> region;
+
+    const size_t block_size_;
+    std::vector<region> regions_;
+    size_t reserved_;
+    char* position_;
+    char* end_;
+};
+
+/// A std compatible allocator over an arena, deallocation is a no-op.
+/// The arena must outlive all containers that use the allocator.
+template <typename Type>
+class arena_allocator
+{
+public:
+    typedef Type value_type;
+
+    template <typename Other>
+    struct rebind
+    {
+        typedef arena_allocator<Other> other;
+    };
+
+    arena_allocator(arena& region);
+
+    template <typename Other>
+    arena_allocator(const arena_allocator<Other>& other);
+
+    Type* allocate(size_t count);
+    void deallocate(Type* pointer, size_t count);
+
+    arena* region() const;
+
+private:
+    arena* region_;
+};
+
+template <typename Left, typename Right>
+bool operator==(const arena_allocator<Left>& left,
+    const arena_allocator<Right>& right);
+
+template <typename Left, typename Right>
+bool operator!=(const arena_allocator<Left>& left,
+    const arena_allocator<Right>& right);
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/arena.ipp>
+
+#endif
@@ -29,6 +29,7 @@
 #include <bitcoin/bitcoin/utility/asio.hpp>
 #include <bitcoin/bitcoin/utility/deadline.hpp>
 #include <bitcoin/bitcoin/utility/delegates.hpp>
+#include <bitcoin/bitcoin/utility/executor.hpp>
 #include <bitcoin/bitcoin/utility/noncopyable.hpp>
 #include <bitcoin/bitcoin/utility/synchronizer.hpp>
 #include <bitcoin/bitcoin/utility/threadpool.hpp>
@@ -53,13 +54,18 @@ namespace libbitcoin {
 
 /// This  class is thread safe.
 /// If the ios service is stopped jobs will not be dispatched.
+/// If an executor is provided concurrent jobs are dispatched to it, while
+/// ordered, unordered, sequenced and delayed jobs remain on the service.
 class BC_API dispatcher
   : noncopyable
 {
 public:
     typedef std::function<void(const code&)> delay_handler;
+    typedef std::function<bool(size_t)> loop_handler;
 
     dispatcher(threadpool& pool, const std::string& name);
+    dispatcher(threadpool& pool, executor& concurrent,
+        const std::string& name);
 
     ////size_t ordered_backlog();
     ////size_t unordered_backlog();
@@ -73,11 +79,14 @@ public:
         BIND_ARGS(args)();
     }
 
-    /// Posts a job to the service. Concurrent and not ordered.
+    /// Posts a job to the executor or service. Concurrent and not ordered.
     template <typename... Args>
     void concurrent(Args&&... args)
     {
-        heap_->concurrent(BIND_ARGS(args));
+        if (executor_ != nullptr)
+            executor_->concurrent(BIND_ARGS(args));
+        else
+            heap_->concurrent(BIND_ARGS(args));
     }
 
     /// Post a job to the strand. Ordered and not concurrent.
@@ -121,6 +130,13 @@ public:
         });
     }
 
+    /// Invokes the job for each index in [0, count) on the service and the
+    /// calling thread, returning once no claimed job remains in progress.
+    /// Indexes are claimed in ascending order, and a job returning false
+    /// stops further claims, so all indexes below a failure are invoked.
+    /// The calling thread participates, so this cannot starve on the pool.
+    void parallel_for(size_t count, loop_handler job);
+
     /// Returns a delegate that will execute the job on the current thread.
     template <typename... Args>
     static auto bound_delegate(Args&&... args) ->
@@ -180,59 +196,59 @@ public:
         };
     }
 
-    /////// Executes multiple identical jobs concurrently until one completes.
-    ////template <typename Count, typename Handler, typename... Args>
-    ////void race(Count count, const std::string& name, Handler&& handler,
-    ////    Args... args)
-    ////{
-    ////    // The first fail will also terminate race and return the code.
-    ////    static const size_t clearance_count = 1;
-    ////    const auto call = synchronize(FORWARD_HANDLER(handler),
-    ////        clearance_count, name, false);
-    ////
-    ////    for (Count iteration = 0; iteration < count; ++iteration)
-    ////        concurrent(BIND_RACE(args, call));
-    ////}
-    ////
-    /////// Executes the job against each member of a collection concurrently.
-    ////template <typename Element, typename Handler, typename... Args>
-    ////void parallel(const std::vector<Element>& collection,
-    ////    const std::string& name, Handler&& handler, Args... args)
-    ////{
-    ////    // Failures are suppressed, success always returned to handler.
-    ////    const auto call = synchronize(FORWARD_HANDLER(handler),
-    ////        collection.size(), name, true);
-    ////
-    ////    for (const auto& element: collection)
-    ////        concurrent(BIND_ELEMENT(args, element, call));
-    ////}
-    ////
-    /////// Disperses the job against each member of a collection without order.
-    ////template <typename Element, typename Handler, typename... Args>
-    ////void disperse(const std::vector<Element>& collection,
-    ////    const std::string& name, Handler&& handler, Args... args)
-    ////{
-    ////    // Failures are suppressed, success always returned to handler.
-    ////    const auto call = synchronize(FORWARD_HANDLER(handler),
-    ////        collection.size(), name, true);
-    ////
-    ////    for (const auto& element: collection)
-    ////        unordered(BIND_ELEMENT(args, element, call));
-    ////}
-    ////
-    /////// Disperses the job against each member of a collection with order.
-    ////template <typename Element, typename Handler, typename... Args>
-    ////void serialize(const std::vector<Element>& collection,
-    ////    const std::string& name, Handler&& handler, Args... args)
-    ////{
-    ////    // Failures are suppressed, success always returned to handler.
-    ////    const auto call = synchronize(FORWARD_HANDLER(handler),
-    ////        collection.size(), name, true);
-    ////
-    ////    for (const auto& element: collection)
-    ////        ordered(BIND_ELEMENT(args, element, call));
-    ////}
-    ////
+    /// Executes multiple identical jobs concurrently until one completes.
+    template <typename Count, typename Handler, typename... Args>
+    void race(Count count, const std::string& name, Handler&& handler,
+        Args... args)
+    {
+        // The first fail will also terminate race and return the code.
+        static const size_t clearance_count = 1;
+        const auto call = synchronize(FORWARD_HANDLER(handler),
+            clearance_count, name, synchronizer_terminate::on_error);
+
+        for (Count iteration = 0; iteration < count; ++iteration)
+            concurrent(BIND_RACE(args, call));
+    }
+
+    /// Executes the job against each member of a collection concurrently.
+    template <typename Element, typename Handler, typename... Args>
+    void parallel(const std::vector<Element>& collection,
+        const std::string& name, Handler&& handler, Args... args)
+    {
+        // Failures are suppressed, success always returned to handler.
+        const auto call = synchronize(FORWARD_HANDLER(handler),
+            collection.size(), name, synchronizer_terminate::on_count);
+
+        for (const auto& element: collection)
+            concurrent(BIND_ELEMENT(args, element, call));
+    }
+
+    /// Disperses the job against each member of a collection without order.
+    template <typename Element, typename Handler, typename... Args>
+    void disperse(const std::vector<Element>& collection,
+        const std::string& name, Handler&& handler, Args... args)
+    {
+        // Failures are suppressed, success always returned to handler.
+        const auto call = synchronize(FORWARD_HANDLER(handler),
+            collection.size(), name, synchronizer_terminate::on_count);
+
+        for (const auto& element: collection)
+            unordered(BIND_ELEMENT(args, element, call));
+    }
+
+    /// Disperses the job against each member of a collection with order.
+    template <typename Element, typename Handler, typename... Args>
+    void serialize(const std::vector<Element>& collection,
+        const std::string& name, Handler&& handler, Args... args)
+    {
+        // Failures are suppressed, success always returned to handler.
+        const auto call = synchronize(FORWARD_HANDLER(handler),
+            collection.size(), name, synchronizer_terminate::on_count);
+
+        for (const auto& element: collection)
+            ordered(BIND_ELEMENT(args, element, call));
+    }
+
     /////// Sequences the job against each member of a collection with order.
     ////template <typename Element, typename Handler, typename... Args>
     ////void sequential(const std::vector<Element>& collection,
@@ -246,17 +262,18 @@ public:
     ////        sequence(BIND_ELEMENT(args, element, call));
     ////}
 
-    /// The size of the dispatcher's threadpool at the time of calling.
+    /// The number of threads available to concurrent jobs.
     inline size_t size() const
     {
-        return pool_.size();
+        return executor_ != nullptr ? executor_->size() : pool_.size();
     }
 
 private:
 
-    // This is thread safe.
+    // These are thread safe.
     work::ptr heap_;
     threadpool& pool_;
+    executor* executor_;
 };
 
 #undef FORWARD_ARGS
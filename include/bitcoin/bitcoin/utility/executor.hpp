@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_EXECUTOR_HPP
+#define LIBBITCOIN_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A work-stealing pool for concurrent (unordered, non-exclusive) jobs.
+/// Each thread owns a queue, taking its own jobs newest first and stealing
+/// the oldest jobs of other threads when empty. Jobs posted from a pool
+/// thread stay on that thread's queue, others are spread across queues.
+class BC_API executor
+  : noncopyable
+{
+public:
+    typedef std::function<void()> job;
+
+    /// Spawn the specified number of threads.
+    executor(size_t number_threads=0,
+        thread_priority priority=thread_priority::normal);
+
+    /// Shut down and join.
+    virtual ~executor();
+
+    /// The number of threads in the pool.
+    size_t size() const;
+
+    /// Queue the job, which is dropped if the pool has been shut down.
+    void concurrent(job&& handler);
+
+    /// Stop accepting jobs, threads exit once all queued jobs are complete.
+    void shutdown();
+
+    /// Wait for all threads in the pool to terminate.
+    /// This must not be called from a thread in the pool.
+    void join();
+
+private:
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<job> jobs;
+    };
+
+    void run(size_t index, thread_priority priority);
+    size_t target();
+    bool take(size_t index, job& out);
+    bool steal(size_t index, job& out);
+
+    // These are thread safe.
+    std::atomic<size_t> pending_;
+    std::atomic<size_t> sleeping_;
+    std::atomic<size_t> next_;
+    std::atomic<bool> stopped_;
+
+    // These are not modified after construction.
+    std::vector<std::unique_ptr<queue>> queues_;
+    std::vector<asio::thread> threads_;
+    std::vector<asio::thread::id> ids_;
+
+    // This is protected by mutex.
+    std::mutex idle_mutex_;
+    std::condition_variable idle_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -25,10 +25,11 @@
 #include <cmath>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <type_traits>
 #include <utility>
-#include <unordered_map>
+#include <unordered_set>
 #include <boost/range/adaptor/reversed.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/compact.hpp>
@@ -44,10 +45,12 @@
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
 #include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/arena.hpp>
 #include <bitcoin/bitcoin/utility/asio.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -199,10 +202,10 @@ bool block::operator!=(const block& other) const
 //-----------------------------------------------------------------------------
 
 // static
-block block::factory(const data_chunk& data)
+block block::factory(const data_chunk& data, bool hash)
 {
     block instance;
-    instance.from_data(data);
+    instance.from_data(data, hash);
     return instance;
 }
 
@@ -222,10 +225,30 @@ block block::factory(reader& source)
     return instance;
 }
 
-bool block::from_data(const data_chunk& data)
+bool block::from_data(const data_chunk& data, bool hash)
 {
-    data_source istream(data);
-    return from_data(istream);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+
+    if (!from_data(source))
+        return false;
+
+    if (!hash)
+        return true;
+
+    // Hash each element from its wire bytes, avoiding reserialization.
+    auto position = data.data();
+    const auto header_size = header::satoshi_fixed_size();
+    header_.cache_hash({ position, position + header_size });
+    position += header_size + message::variable_uint_size(transactions_.size());
+
+    for (auto& tx: transactions_)
+    {
+        const auto tx_size = tx.serialized_size(true);
+        tx.cache_hash({ position, position + tx_size });
+        position += tx_size;
+    }
+
+    return true;
 }
 
 bool block::from_data(std::istream& stream)
@@ -634,37 +657,7 @@ bool block::is_distinct_transaction_set() const
 
 hash_digest block::generate_merkle_root() const
 {
-    if (transactions_.empty())
-        return null_hash;
-
-    hash_list merkle, update;
-
-    auto hasher = [&merkle](const transaction& tx)
-    {
-        merkle.push_back(tx.hash());
-    };
-
-    // Hash ordering matters, don't use std::transform here.
-    std::for_each(transactions_.begin(), transactions_.end(), hasher);
-
-    // Initial capacity is half of the original list (clear doesn't reset).
-    update.reserve((merkle.size() + 1) / 2);
-
-    while (merkle.size() > 1)
-    {
-        // If number of hashes is odd, duplicate last hash in the list.
-        if (merkle.size() % 2 != 0)
-            merkle.push_back(merkle.back());
-
-        for (auto it = merkle.begin(); it != merkle.end(); it += 2)
-            update.push_back(bitcoin_hash(build_chunk({ it[0], it[1] })));
-
-        std::swap(merkle, update);
-        update.clear();
-    }
-
-    // There is now only one item in the list.
-    return merkle.front();
+    return merkle_root(to_hashes());
 }
 
 //****************************************************************************
@@ -673,7 +666,15 @@ hash_digest block::generate_merkle_root() const
 //*****************************************************************************
 bool block::is_forward_reference() const
 {
-    std::unordered_map<hash_digest, bool> hashes(transactions_.size());
+    typedef arena_allocator<hash_digest> allocator;
+    typedef std::unordered_set<hash_digest, std::hash<hash_digest>,
+        std::equal_to<hash_digest>, allocator> hash_set;
+
+    // Set nodes share one region, released together on return.
+    arena region;
+    hash_set hashes(transactions_.size(), std::hash<hash_digest>(),
+        std::equal_to<hash_digest>(), allocator(region));
+
     const auto is_forward = [&hashes](const input& input)
     {
         return hashes.count(input.previous_output().hash()) != 0;
@@ -681,7 +682,7 @@ bool block::is_forward_reference() const
 
     for (const auto& tx: reverse(transactions_))
     {
-        hashes.emplace(tx.hash(), true);
+        hashes.emplace(tx.hash());
 
         if (std::any_of(tx.inputs().begin(), tx.inputs().end(), is_forward))
             return true;
@@ -702,10 +703,8 @@ bool block::is_internal_double_spend() const
 
     // Merge the prevouts of all non-coinbase transactions into one set.
     for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx)
-    {
-        auto out = tx->previous_outputs();
-        std::move(out.begin(), out.end(), std::inserter(outs, outs.end()));
-    }
+        for (const auto& input: tx->inputs())
+            outs.push_back(input.previous_output());
 
     std::sort(outs.begin(), outs.end());
     const auto distinct_end = std::unique(outs.begin(), outs.end());
@@ -785,12 +784,71 @@ code block::connect_transactions(const chain_state& state) const
     code ec;
 
     for (const auto& tx: transactions_)
-        if ((ec = tx.connect(state)))
+        if ((ec = tx.connect(state, validation.scripts, validation.traces)))
             return ec;
 
     return error::success;
 }
 
+code block::connect_transactions(const chain_state& state,
+    dispatcher& dispatch) const
+{
+    input_point failure;
+    return connect_transactions(state, dispatch, failure);
+}
+
+// Inputs are claimed in block order and claims stop at the first failure, so
+// every input preceding the lowest failure is verified, making it definitive.
+code block::connect_transactions(const chain_state& state,
+    dispatcher& dispatch, input_point& out_failure) const
+{
+    typedef std::pair<size_t, size_t> position;
+    std::vector<position> positions;
+    positions.reserve(total_non_coinbase_inputs());
+
+    // Coinbase inputs always connect, so there is no reason to dispatch them.
+    for (size_t tx = 0; tx < transactions_.size(); ++tx)
+        if (!transactions_[tx].is_coinbase())
+            for (size_t input = 0;
+                input < transactions_[tx].inputs().size(); ++input)
+                positions.emplace_back(tx, input);
+
+    std::mutex mutex;
+    code result(error::success);
+    auto lowest = positions.size();
+
+    const auto connect_input = [&](size_t index)
+    {
+        const auto& at = positions[index];
+        const auto ec = transactions_[at.first].connect_input(state,
+            at.second, validation.scripts, validation.traces);
+
+        if (!ec)
+            return true;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (index < lowest)
+        {
+            lowest = index;
+            result = ec;
+        }
+
+        return false;
+    };
+
+    dispatch.parallel_for(positions.size(), connect_input);
+
+    if (result)
+    {
+        const auto& at = positions[lowest];
+        out_failure = { transactions_[at.first].hash(),
+            static_cast<uint32_t>(at.second) };
+    }
+
+    return result;
+}
+
 // Validation.
 //-----------------------------------------------------------------------------
 
@@ -906,5 +964,16 @@ code block::connect(const chain_state& state) const
         return connect_transactions(state);
 }
 
+code block::connect(const chain_state& state, dispatcher& dispatch) const
+{
+    validation.start_connect = asio::steady_clock::now();
+
+    if (state.is_under_checkpoint())
+        return error::success;
+
+    else
+        return connect_transactions(state, dispatch);
+}
+
 } // namespace chain
 } // namespace libbitcoin
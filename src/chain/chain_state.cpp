@@ -19,11 +19,14 @@
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 #include <bitcoin/bitcoin/chain/block.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/compact.hpp>
+#include <bitcoin/bitcoin/chain/header_history.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/config/checkpoint.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
@@ -135,48 +138,24 @@ inline bool bip65(size_t height, bool frozen, bool mainnet, bool testnet)
          (regtest && height >= regtest_bip65_freeze));
 }
 
-inline uint32_t timestamp_high(const chain_state::data& values)
-{
-    return values.timestamp.ordered.back();
-}
-
-inline uint32_t bits_high(const chain_state::data& values)
-{
-    return values.bits.ordered.back();
-}
-
 // activation
 //-----------------------------------------------------------------------------
 
-chain_state::activations chain_state::activation(const data& values,
+chain_state::activations chain_state::activation(const shared_data& values,
     uint32_t forks)
 {
     const auto height = values.height;
     const auto version = values.version.self;
-    const auto& history = values.version.ordered;
+    const auto& counts = values.version.counts;
     const auto frozen = script::is_enabled(forks, rule_fork::bip90_rule);
     const auto testnet = script::is_enabled(forks, rule_fork::easy_blocks);
     const auto retarget = script::is_enabled(forks, rule_fork::retarget);
     const auto mainnet = retarget && !testnet;
 
-    //*************************************************************************
-    // CONSENSUS: Though unspecified in bip34, the satoshi implementation
-    // performed this comparison using the signed integer version value.
-    //*************************************************************************
-    const auto ge = [](uint32_t value, size_t version)
-    {
-        return static_cast<int32_t>(value) >= version;
-    };
-
-    // Declare bip34-based version predicates.
-    const auto ge_2 = [=](uint32_t value) { return ge(value, bip34_version); };
-    const auto ge_3 = [=](uint32_t value) { return ge(value, bip66_version); };
-    const auto ge_4 = [=](uint32_t value) { return ge(value, bip65_version); };
-
-    // Compute bip34-based activation version summaries.
-    const auto count_2 = std::count_if(history.begin(), history.end(), ge_2);
-    const auto count_3 = std::count_if(history.begin(), history.end(), ge_3);
-    const auto count_4 = std::count_if(history.begin(), history.end(), ge_4);
+    // The bip34-based activation version summaries (see count_version).
+    const auto count_2 = counts.bip34;
+    const auto count_3 = counts.bip66;
+    const auto count_4 = counts.bip65;
 
     // Frozen activations (require version and enforce above freeze height).
     const auto bip34_ice = bip34(height, frozen, mainnet, testnet);
@@ -264,6 +243,30 @@ chain_state::activations chain_state::activation(const data& values,
     return result;
 }
 
+// Add or remove a sampled version from the bip34-based version summaries.
+void chain_state::count_version(version_counts& counts, uint32_t version,
+    bool add)
+{
+    //*************************************************************************
+    // CONSENSUS: Though unspecified in bip34, the satoshi implementation
+    // performed this comparison using the signed integer version value.
+    //*************************************************************************
+    const auto ge = [](uint32_t value, size_t version)
+    {
+        return static_cast<int32_t>(value) >= version;
+    };
+
+    const auto change = [add](size_t& count, bool counted)
+    {
+        if (counted)
+            count = add ? count + 1u : count - 1u;
+    };
+
+    change(counts.bip34, ge(version, bip34_version));
+    change(counts.bip66, ge(version, bip66_version));
+    change(counts.bip65, ge(version, bip65_version));
+}
+
 size_t chain_state::bits_count(size_t height, uint32_t forks)
 {
     const auto testnet = script::is_enabled(forks, rule_fork::easy_blocks);
@@ -333,23 +336,40 @@ size_t chain_state::bip9_bit0_height(size_t height, uint32_t forks)
 // median_time_past
 //-----------------------------------------------------------------------------
 
-uint32_t chain_state::median_time_past(const data& values, uint32_t)
+uint32_t chain_state::median_time_past(const shared_data& values, uint32_t)
 {
-    // Create a copy for the in-place sort.
-    auto times = values.timestamp.ordered;
+    typedef std::array<uint32_t, median_time_past_interval> sample;
+    const auto& history = values.timestamp.ordered;
+    const auto count = history.size();
 
-    // Sort the times by value to obtain the median.
-    std::sort(times.begin(), times.end());
+    if (count == 0)
+        return 0;
 
     // Consensus defines median time using modulo 2 element selection.
     // This differs from arithmetic median which averages two middle values.
-    return times.empty() ? 0 : times[times.size() / 2];
+    const auto median = [count](uint32_t* begin)
+    {
+        std::nth_element(begin, begin + count / 2, begin + count);
+        return begin[count / 2];
+    };
+
+    // Promotion bounds the history to the interval, avoiding allocation.
+    if (count <= median_time_past_interval)
+    {
+        sample times;
+        std::copy(history.begin(), history.end(), times.begin());
+        return median(times.data());
+    }
+
+    std::vector<uint32_t> times(history.begin(), history.end());
+    return median(times.data());
 }
 
 // work_required
 //-----------------------------------------------------------------------------
 
-uint32_t chain_state::work_required(const data& values, uint32_t forks)
+uint32_t chain_state::work_required(const shared_data& values,
+    uint32_t forks)
 {
     // Invalid parameter via public interface, test is_valid for results.
     if (values.height == 0)
@@ -357,7 +377,7 @@ uint32_t chain_state::work_required(const data& values, uint32_t forks)
 
     // Regtest bypasses all retargeting.
     if (!script::is_enabled(forks, rule_fork::retarget))
-        return bits_high(values);
+        return values.bits.ordered.back();
 
     if (is_retarget_height(values.height))
         return work_required_retarget(values);
@@ -365,14 +385,14 @@ uint32_t chain_state::work_required(const data& values, uint32_t forks)
     if (script::is_enabled(forks, rule_fork::easy_blocks))
         return easy_work_required(values);
 
-    return bits_high(values);
+    return values.bits.ordered.back();
 }
 
-uint32_t chain_state::work_required_retarget(const data& values)
+uint32_t chain_state::work_required_retarget(const shared_data& values)
 {
     static const uint256_t pow_limit(compact{ retarget_proof_of_work_limit });
 
-    const compact bits(bits_high(values));
+    const compact bits(values.bits.ordered.back());
     BITCOIN_ASSERT_MSG(!bits.is_overflowed(), "previous block has bad bits");
 
     uint256_t target(bits);
@@ -385,9 +405,9 @@ uint32_t chain_state::work_required_retarget(const data& values)
 }
 
 // Get the bounded total time spanning the highest 2016 blocks.
-uint32_t chain_state::retarget_timespan(const data& values)
+uint32_t chain_state::retarget_timespan(const shared_data& values)
 {
-    const auto high = timestamp_high(values);
+    const auto high = values.timestamp.ordered.back();
     const auto retarget = values.timestamp.retarget;
 
     //*************************************************************************
@@ -398,7 +418,7 @@ uint32_t chain_state::retarget_timespan(const data& values)
     return range_constrain(timespan, min_timespan, max_timespan);
 }
 
-uint32_t chain_state::easy_work_required(const data& values)
+uint32_t chain_state::easy_work_required(const shared_data& values)
 {
     BITCOIN_ASSERT(values.height != 0);
 
@@ -406,6 +426,13 @@ uint32_t chain_state::easy_work_required(const data& values)
     if (values.timestamp.self > easy_time_limit(values))
         return retarget_proof_of_work_limit;
 
+    // This is maintained on promotion, see easy_bits.
+    return values.bits.easy;
+}
+
+// The easy bits of populated state, maintained thereafter by promotion.
+uint32_t chain_state::easy_bits(const data& values)
+{
     auto height = values.height;
     auto& bits = values.bits.ordered;
 
@@ -415,14 +442,14 @@ uint32_t chain_state::easy_work_required(const data& values)
             return *bit;
 
     // Since the set of heights is either a full retarget range or ends at
-    // zero this is not reachable unless the data set is invalid.
-    BITCOIN_ASSERT(false);
+    // zero this is not reachable unless the data set is invalid or is not
+    // for easy work (e.g. at a retarget height).
     return retarget_proof_of_work_limit;
 }
 
-uint32_t chain_state::easy_time_limit(const chain_state::data& values)
+uint32_t chain_state::easy_time_limit(const shared_data& values)
 {
-    const int64_t high = timestamp_high(values);
+    const int64_t high = values.timestamp.ordered.back();
     const int64_t spacing = easy_spacing_seconds;
 
     //*************************************************************************
@@ -512,8 +539,34 @@ uint32_t chain_state::signal_version(uint32_t forks)
     return first_version;
 }
 
+// Histories are copied from the raw data once, after which they are shared.
+chain_state::shared_data chain_state::to_shared(data&& values)
+{
+    version_counts counts{ 0, 0, 0 };
+    const auto& versions = values.version.ordered;
+
+    for (const auto version: versions)
+        count_version(counts, version, true);
+
+    return
+    {
+        values.height,
+        values.hash,
+        values.allow_collisions_hash,
+        values.bip9_bit0_hash,
+        { values.bits.self, { values.bits.ordered }, easy_bits(values) },
+        { values.version.self, { versions }, counts },
+        {
+            values.timestamp.self,
+            values.timestamp.retarget,
+            { values.timestamp.ordered }
+        }
+    };
+}
+
 // This is promotion from a preceding height to the next.
-chain_state::data chain_state::to_pool(const chain_state& top)
+// Histories are shared with the top state, so this is constant time.
+chain_state::shared_data chain_state::to_pool(const chain_state& top)
 {
     // Alias configured forks.
     const auto forks = top.forks_;
@@ -531,6 +584,11 @@ chain_state::data chain_state::to_pool(const chain_state& top)
     data.bits.ordered.push_back(data.bits.self);
     data.version.ordered.push_back(data.version.self);
     data.timestamp.ordered.push_back(data.timestamp.self);
+    count_version(data.version.counts, data.version.self, true);
+
+    // The previous block replaces the easy bits if it satisfies the search.
+    if (is_retarget_or_non_limit(height - 1u, data.bits.self))
+        data.bits.easy = data.bits.self;
 
     // If bits collection overflows, dequeue oldest member.
     if (data.bits.ordered.size() > bits_count(height, forks))
@@ -538,7 +596,11 @@ chain_state::data chain_state::to_pool(const chain_state& top)
 
     // If version collection overflows, dequeue oldest member.
     if (data.version.ordered.size() > version_count(height, forks))
+    {
+        count_version(data.version.counts, data.version.ordered.front(),
+            false);
         data.version.ordered.pop_front();
+    }
 
     // If timestamp collection overflows, dequeue oldest member.
     if (data.timestamp.ordered.size() > timestamp_count(height, forks))
@@ -573,7 +635,7 @@ chain_state::chain_state(const chain_state& top)
 {
 }
 
-chain_state::data chain_state::to_block(const chain_state& pool,
+chain_state::shared_data chain_state::to_block(const chain_state& pool,
     const block& block)
 {
     // Alias configured forks.
@@ -618,7 +680,7 @@ chain_state::chain_state(const chain_state& pool, const block& block)
 {
 }
 
-chain_state::data chain_state::to_header(const chain_state& parent,
+chain_state::shared_data chain_state::to_header(const chain_state& parent,
     const header& header)
 {
     // Alias configured forks.
@@ -667,7 +729,7 @@ chain_state::chain_state(const chain_state& parent, const header& header)
 // TODO: remove allow_collisions fork by incorporating into bip30 revert.
 chain_state::chain_state(data&& values, const checkpoints& checkpoints,
     uint32_t forks)
-  : data_(std::move(values)),
+  : data_(to_shared(std::move(values))),
     forks_(forks | rule_fork::allow_collisions),
     checkpoints_(checkpoints),
     active_(activation(data_, forks_)),
@@ -27,7 +27,7 @@
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -149,10 +149,10 @@ bool header::operator!=(const header& other) const
 //-----------------------------------------------------------------------------
 
 // static
-header header::factory(const data_chunk& data, bool wire)
+header header::factory(const data_chunk& data, bool wire, bool hash)
 {
     header instance;
-    instance.from_data(data, wire);
+    instance.from_data(data, wire, hash);
     return instance;
 }
 
@@ -188,10 +188,18 @@ header header::factory(reader& source, const hash_digest& hash, bool wire)
     return instance;
 }
 
-bool header::from_data(const data_chunk& data, bool wire)
+bool header::from_data(const data_chunk& data, bool wire, bool hash)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+
+    if (!from_data(source, wire))
+        return false;
+
+    // The hash covers only the wire serialization.
+    if (hash)
+        cache_hash({ data.data(), data.data() + satoshi_fixed_size() });
+
+    return true;
 }
 
 bool header::from_data(std::istream& stream, bool wire)
@@ -244,6 +252,12 @@ void header::reset()
     invalidate_cache();
 }
 
+// protected
+void header::cache_hash(data_slice wire)
+{
+    hash_ = std::make_shared<hash_digest>(bitcoin_hash(wire));
+}
+
 bool header::is_valid() const
 {
     return (version_ != 0) ||
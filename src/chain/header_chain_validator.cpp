@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/header_chain_validator.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <bitcoin/bitcoin/chain/chain_state.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/config/checkpoint.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::config;
+using namespace bc::machine;
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+header_chain_validator::header_chain_validator(chain_state::ptr parent,
+    const chain_state::checkpoints& checkpoints)
+  : tip_(parent), validated_(0), checkpoints_(checkpoints)
+{
+    BITCOIN_ASSERT(parent);
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+chain_state::ptr header_chain_validator::tip() const
+{
+    return tip_;
+}
+
+size_t header_chain_validator::validated() const
+{
+    return validated_;
+}
+
+// Validation.
+//-----------------------------------------------------------------------------
+
+code header_chain_validator::validate(const header::list& headers)
+{
+    code ec(error::success);
+    size_t index = 0;
+
+    for (; index < headers.size(); ++index)
+        if ((ec = check(headers, index)))
+            break;
+
+    return accept(headers, index, ec);
+}
+
+// Headers are claimed in order and claims stop at the first failure, so every
+// header preceding the lowest failure is checked, making it definitive.
+code header_chain_validator::validate(const header::list& headers,
+    dispatcher& dispatch)
+{
+    std::mutex mutex;
+    code result(error::success);
+    auto lowest = headers.size();
+
+    const auto check_header = [&](size_t index)
+    {
+        const auto ec = check(headers, index);
+
+        if (!ec)
+            return true;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (index < lowest)
+        {
+            lowest = index;
+            result = ec;
+        }
+
+        return false;
+    };
+
+    dispatch.parallel_for(headers.size(), check_header);
+    return accept(headers, lowest, result);
+}
+
+// The context-free checks of one header, in sequential validation order.
+code header_chain_validator::check(const header::list& headers,
+    size_t index) const
+{
+    const auto& header = headers[index];
+    const auto previous = index == 0 ? tip_->hash() :
+        headers[index - 1].hash();
+
+    if (header.previous_block_hash() != previous)
+        return error::invalid_previous_block;
+
+    const auto ec = header.check(tip_->is_enabled(rule_fork::retarget));
+
+    if (ec)
+        return ec;
+
+    // Work required is accepted before checkpoints, so defer the conflict.
+    const auto height = tip_->height() + index + 1;
+    return checkpoint::validate(header.hash(), height, checkpoints_) ?
+        error::success : error::checkpoints_failed;
+}
+
+// Promote the tip over the checked headers, applying the contextual rules.
+// A checked checkpoint conflict is also an accept failure, but accept tests
+// work required first, so the conflicting header is accepted for its code.
+code header_chain_validator::accept(const header::list& headers,
+    size_t checked, const code& failure)
+{
+    const auto count = failure == error::checkpoints_failed ? checked + 1 :
+        checked;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto& header = headers[index];
+        const auto state = std::make_shared<chain_state>(*tip_, header);
+        const auto ec = header.accept(*state);
+
+        if (ec)
+            return ec;
+
+        header.validation.height = state->height();
+        header.validation.state = state;
+        tip_ = state;
+        ++validated_;
+    }
+
+    return failure;
+}
+
+} // namespace chain
+} // namespace libbitcoin
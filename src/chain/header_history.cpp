@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/header_history.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Storage is allocated at four times the window, so a full storage is
+// replaced by copying the window at most once for each three extensions
+// of the window size (amortized constant time per extension).
+static constexpr size_t minimum_capacity = 64;
+static constexpr size_t capacity_factor = 4;
+
+static size_t capacity(size_t size)
+{
+    return std::max(minimum_capacity, size * capacity_factor);
+}
+
+header_history::storage::storage(size_t capacity)
+  : values(capacity), size(0)
+{
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+header_history::header_history()
+  : storage_(std::make_shared<storage>(minimum_capacity)),
+    begin_(0),
+    end_(0)
+{
+}
+
+header_history::header_history(const list& values)
+  : storage_(std::make_shared<storage>(capacity(values.size()))),
+    begin_(0),
+    end_(values.size())
+{
+    std::copy(values.begin(), values.end(), storage_->values.begin());
+    storage_->size = end_;
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool header_history::empty() const
+{
+    return begin_ == end_;
+}
+
+size_t header_history::size() const
+{
+    return end_ - begin_;
+}
+
+uint32_t header_history::operator[](size_t index) const
+{
+    BITCOIN_ASSERT(index < size());
+    return storage_->values[begin_ + index];
+}
+
+uint32_t header_history::front() const
+{
+    BITCOIN_ASSERT(!empty());
+    return storage_->values[begin_];
+}
+
+uint32_t header_history::back() const
+{
+    BITCOIN_ASSERT(!empty());
+    return storage_->values[end_ - 1];
+}
+
+header_history::const_iterator header_history::begin() const
+{
+    return storage_->values.begin() + begin_;
+}
+
+header_history::const_iterator header_history::end() const
+{
+    return storage_->values.begin() + end_;
+}
+
+header_history::const_reverse_iterator header_history::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+header_history::const_reverse_iterator header_history::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+// Modifiers.
+//-----------------------------------------------------------------------------
+
+// Only the first copy to extend a given end claims the storage position.
+void header_history::push_back(uint32_t value)
+{
+    auto claimed = end_;
+
+    if (end_ == storage_->values.size() ||
+        !storage_->size.compare_exchange_strong(claimed, end_ + 1))
+        reallocate();
+
+    storage_->values[end_++] = value;
+}
+
+void header_history::pop_front()
+{
+    BITCOIN_ASSERT(!empty());
+    ++begin_;
+}
+
+// private
+// Copy the window to new storage, claiming the position following it.
+void header_history::reallocate()
+{
+    const auto size = this->size();
+    const auto replacement = std::make_shared<storage>(capacity(size + 1));
+    std::copy(begin(), end(), replacement->values.begin());
+    replacement->size = size + 1;
+
+    storage_ = replacement;
+    begin_ = 0;
+    end_ = size;
+}
+
+} // namespace chain
+} // namespace libbitcoin
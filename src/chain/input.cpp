@@ -21,7 +21,7 @@
 #include <sstream>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/wallet/payment_address.hpp>
@@ -76,8 +76,7 @@ input::input(const output_point& previous_output, const chain::script& script,
 // Private cache access for copy/move construction.
 input::addresses_ptr input::addresses_cache() const
 {
-    shared_lock lock(mutex_);
-    return addresses_;
+    return std::atomic_load(&addresses_);
 }
 
 // Operators.
@@ -139,8 +138,8 @@ input input::factory(reader& source, bool wire)
 
 bool input::from_data(const data_chunk& data, bool wire)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire);
 }
 
 bool input::from_data(std::istream& stream, bool wire)
@@ -268,21 +267,7 @@ void input::set_sequence(uint32_t value)
 // protected
 void input::invalidate_cache() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (addresses_)
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        addresses_.reset();
-        //---------------------------------------------------------------------
-        mutex_.unlock_and_lock_upgrade();
-    }
-
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+    std::atomic_store(&addresses_, addresses_ptr());
 }
 
 payment_address input::address() const
@@ -293,25 +278,17 @@ payment_address input::address() const
 
 payment_address::list input::addresses() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
+    auto cached = std::atomic_load(&addresses_);
 
-    if (!addresses_)
+    // Concurrent extractions are equivalent, so the last to publish is kept.
+    if (!cached)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        addresses_ = std::make_shared<payment_address::list>(
+        cached = std::make_shared<payment_address::list>(
             payment_address::extract_input(script_));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
+        std::atomic_store(&addresses_, cached);
     }
 
-    const auto addresses = *addresses_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return addresses;
+    return *cached;
 }
 
 // Validation helpers.
@@ -22,7 +22,7 @@
 #include <sstream>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/wallet/payment_address.hpp>
@@ -81,8 +81,7 @@ output::output(uint64_t value, const chain::script& script)
 // Private cache access for copy/move construction.
 output::addresses_ptr output::addresses_cache() const
 {
-    shared_lock lock(mutex_);
-    return addresses_;
+    return std::atomic_load(&addresses_);
 }
 
 // Operators.
@@ -142,8 +141,8 @@ output output::factory(reader& source, bool wire)
 
 bool output::from_data(const data_chunk& data, bool wire)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire);
 }
 
 bool output::from_data(std::istream& stream, bool wire)
@@ -257,21 +256,7 @@ void output::set_script(chain::script&& value)
 // protected
 void output::invalidate_cache() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (addresses_)
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        addresses_.reset();
-        //---------------------------------------------------------------------
-        mutex_.unlock_and_lock_upgrade();
-    }
-
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+    std::atomic_store(&addresses_, addresses_ptr());
 }
 
 payment_address output::address(uint8_t p2kh_version,
@@ -284,26 +269,18 @@ payment_address output::address(uint8_t p2kh_version,
 payment_address::list output::addresses(uint8_t p2kh_version,
     uint8_t p2sh_version) const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
+    auto cached = std::atomic_load(&addresses_);
 
-    if (!addresses_)
+    // Concurrent extractions are equivalent, so the last to publish is kept.
+    if (!cached)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        addresses_ = std::make_shared<payment_address::list>(
+        cached = std::make_shared<payment_address::list>(
             payment_address::extract_output(script_, p2kh_version,
-                p2sh_version));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
+            p2sh_version));
+        std::atomic_store(&addresses_, cached);
     }
 
-    const auto addresses = *addresses_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return addresses;
+    return *cached;
 }
 
 // Validation helpers.
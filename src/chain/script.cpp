@@ -33,6 +33,8 @@
 #include <bitcoin/bitcoin/formats/base_16.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
 #include <bitcoin/bitcoin/machine/interpreter.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
@@ -40,9 +42,10 @@
 #include <bitcoin/bitcoin/machine/script_pattern.hpp>
 #include <bitcoin/bitcoin/machine/sighash_algorithm.hpp>
 #include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/string.hpp>
@@ -53,31 +56,27 @@ namespace chain {
 using namespace bc::machine;
 using namespace boost::adaptors;
 
-// bit.ly/2cPazSa
-static const auto one_hash = hash_literal(
-    "0000000000000000000000000000000000000000000000000000000000000001");
-
 // Constructors.
 //-----------------------------------------------------------------------------
 
 // A default instance is invalid (until modified).
 script::script()
-  : cached_(false),
-    valid_(false)
+  : valid_(false)
 {
 }
 
 script::script(script&& other)
-  : operations_(std::move(other.operations_move())),
-    cached_(!operations_.empty()),
+  : operations_(other.operations_cache()),
+    analysis_(other.analysis_cache()),
     bytes_(std::move(other.bytes_)),
     valid_(other.valid_)
 {
 }
 
+// Caches are immutable once published, so copies share them.
 script::script(const script& other)
-  : operations_(other.operations_copy()),
-    cached_(!operations_.empty()),
+  : operations_(other.operations_cache()),
+    analysis_(other.analysis_cache()),
     bytes_(other.bytes_),
     valid_(other.valid_)
 {
@@ -103,7 +102,6 @@ script::script(data_chunk&& encoded, bool prefix)
 
     // This is an optimization that avoids streaming the encoded bytes.
     bytes_ = std::move(encoded);
-    cached_ = false;
     valid_ = true;
 }
 
@@ -112,18 +110,16 @@ script::script(const data_chunk& encoded, bool prefix)
     valid_ = from_data(encoded, prefix);
 }
 
-// Private cache access for move construction.
-script::operation::list& script::operations_move()
+// Private cache access for copy/move construction.
+script::operations_ptr script::operations_cache() const
 {
-    shared_lock lock(mutex_);
-    return operations_;
+    return std::atomic_load(&operations_);
 }
 
-// Private cache access for copy construction.
-const script::operation::list& script::operations_copy() const
+// Private cache access for copy/move construction.
+script::analysis_ptr script::analysis_cache() const
 {
-    shared_lock lock(mutex_);
-    return operations_;
+    return std::atomic_load(&analysis_);
 }
 
 // Operators.
@@ -132,8 +128,8 @@ const script::operation::list& script::operations_copy() const
 // Concurrent read/write is not supported, so no critical section.
 script& script::operator=(script&& other)
 {
-    operations_ = other.operations_move();
-    cached_ = !operations_.empty();
+    operations_ = other.operations_cache();
+    analysis_ = other.analysis_cache();
     bytes_ = std::move(other.bytes_);
     valid_ = other.valid_;
     return *this;
@@ -142,8 +138,8 @@ script& script::operator=(script&& other)
 // Concurrent read/write is not supported, so no critical section.
 script& script::operator=(const script& other)
 {
-    operations_ = other.operations_copy();
-    cached_ = !operations_.empty();
+    operations_ = other.operations_cache();
+    analysis_ = other.analysis_cache();
     bytes_ = other.bytes_;
     valid_ = other.valid_;
     return *this;
@@ -188,8 +184,8 @@ script script::factory(reader& source, bool prefix)
 
 bool script::from_data(const data_chunk& encoded, bool prefix)
 {
-    data_source istream(encoded);
-    return from_data(istream, prefix);
+    auto source = make_safe_deserializer(encoded.begin(), encoded.end());
+    return from_data(source, prefix);
 }
 
 bool script::from_data(std::istream& stream, bool prefix)
@@ -250,8 +246,8 @@ void script::from_operations(operation::list&& ops)
 {
     ////reset();
     bytes_ = operations_to_data(ops);
-    operations_ = std::move(ops);
-    cached_ = true;
+    operations_ = std::make_shared<const operation::list>(std::move(ops));
+    analysis_.reset();
     valid_ = true;
 }
 
@@ -260,8 +256,8 @@ void script::from_operations(const operation::list& ops)
 {
     ////reset();
     bytes_ = operations_to_data(ops);
-    operations_ = ops;
-    cached_ = true;
+    operations_ = std::make_shared<const operation::list>(ops);
+    analysis_.reset();
     valid_ = true;
 }
 
@@ -300,9 +296,8 @@ void script::reset()
     bytes_.clear();
     bytes_.shrink_to_fit();
     valid_ = false;
-    cached_ = false;
-    operations_.clear();
-    operations_.shrink_to_fit();
+    operations_.reset();
+    analysis_.reset();
 }
 
 bool script::is_valid() const
@@ -316,7 +311,7 @@ bool script::is_valid_operations() const
 {
     // Script validity is independent of individual operation validity.
     // There is a trailing invalid/default op if a push op had a size mismatch.
-    return operations().empty() || operations_.back().is_valid();
+    return analyze().valid_operations;
 }
 
 // Serialization.
@@ -367,7 +362,6 @@ std::string script::to_string(uint32_t active_forks) const
 // Iteration.
 //-----------------------------------------------------------------------------
 // These are syntactic sugar that allow the caller to iterate ops directly.
-// The first operations access must be method-based to guarantee the cache.
 
 void script::clear()
 {
@@ -430,30 +424,27 @@ size_t script::serialized_size(bool prefix) const
     return size;
 }
 
+const data_chunk& script::bytes() const
+{
+    return bytes_;
+}
+
 // protected
+// Concurrent decodes race to publish and the losers adopt the winning list, so
+// a published list is never replaced while it may be referenced.
 const operation::list& script::operations() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
+    const auto cached = std::atomic_load(&operations_);
 
-    if (cached_)
-    {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return operations_;
-    }
+    if (cached)
+        return *cached;
 
     operation op;
-    data_source istream(bytes_);
-    istream_reader source(istream);
-    const auto size = bytes_.size();
-
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    mutex_.unlock_upgrade_and_lock();
+    auto source = make_safe_deserializer(bytes_.begin(), bytes_.end());
+    const auto ops = std::make_shared<operation::list>();
 
     // One operation per byte is the upper limit of operations.
-    operations_.reserve(size);
+    ops->reserve(bytes_.size());
 
     // ************************************************************************
     // CONSENSUS: In the case of a coinbase script we must parse the entire
@@ -468,153 +459,228 @@ const operation::list& script::operations() const
     while (!source.is_exhausted())
     {
         op.from_data(source);
-        operations_.push_back(std::move(op));
+        ops->push_back(std::move(op));
     }
 
-    operations_.shrink_to_fit();
-    cached_ = true;
+    ops->shrink_to_fit();
+    operations_ptr expected;
+    operations_ptr desired(ops);
 
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
+    if (!std::atomic_compare_exchange_strong(&operations_, &expected, desired))
+        return *expected;
 
-    return operations_;
+    return *desired;
 }
 
-// Signing.
-//-----------------------------------------------------------------------------
-
-inline sighash_algorithm to_sighash_enum(uint8_t sighash_type)
+inline uint32_t multisig_sigops(bool accurate, opcode preceding)
 {
-    switch (sighash_type & sighash_algorithm::mask)
-    {
-        case sighash_algorithm::single:
-            return sighash_algorithm::single;
-        case sighash_algorithm::none:
-            return sighash_algorithm::none;
-        default:
-            return sighash_algorithm::all;
-    }
+    return accurate && operation::is_positive(preceding) ?
+        operation::opcode_to_positive(preceding) : multisig_default_sigops;
 }
 
-inline uint8_t is_sighash_enum(uint8_t sighash_type, sighash_algorithm value)
+// This mirrors the decode of script::operations, in which a truncated or
+// oversized push is an invalid (non-push) operation that ends the script.
+static script::analysis analyze_bytes(data_slice bytes, bool embedded)
 {
-    return to_sighash_enum(sighash_type) == value;
-}
+    opcode code;
+    size_t size;
+    size_t position = 0;
+    size_t last_push = 0;
+    size_t last_size = 0;
+    auto preceding = opcode::push_negative_1;
+    script::analysis out{ 0, 0, 0, true, true, false, true };
 
-static hash_digest sign_none(const transaction& tx, uint32_t input_index,
-    const script& script_code, uint8_t sighash_type)
-{
-    input::list ins;
-    const auto& inputs = tx.inputs();
-    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
-    ins.reserve(any ? 1 : inputs.size());
+    while (position < bytes.size())
+    {
+        if (!bytecode::read(code, size, position, bytes))
+        {
+            out.push_only = false;
+            out.relaxed_push = false;
+            out.valid_operations = false;
+            break;
+        }
 
-    BITCOIN_ASSERT(input_index < inputs.size());
-    const auto& self = inputs[input_index];
+        if (code == opcode::checksig ||
+            code == opcode::checksigverify)
+        {
+            ++out.sigops;
+            ++out.accurate_sigops;
+        }
+        else if (
+            code == opcode::checkmultisig ||
+            code == opcode::checkmultisigverify)
+        {
+            out.sigops += multisig_sigops(false, preceding);
+            out.accurate_sigops += multisig_sigops(true, preceding);
+        }
 
-    if (any)
-    {
-        // Retain only self.
-        ins.emplace_back(self.previous_output(), script_code, self.sequence());
+        out.push_only &= operation::is_push(code);
+        out.relaxed_push &= operation::is_relaxed_push(code);
+        last_push = position;
+        last_size = size;
+        preceding = code;
+        position += size;
     }
-    else
-    {
-        // Erase all input scripts and sequences.
-        for (const auto& input: inputs)
-            ins.emplace_back(input.previous_output(), script{}, 0);
 
-        // Replace self that is lost in the loop.
-        ins[input_index].set_script(script_code);
-        ins[input_index].set_sequence(self.sequence());
+    // CONSENSUS: this pattern is used to activate bip16 validation rules.
+    static const auto hash160 = static_cast<uint8_t>(opcode::hash160);
+    static const auto push_20 = static_cast<uint8_t>(opcode::push_size_20);
+    static const auto equal = static_cast<uint8_t>(opcode::equal);
+    const auto data = bytes.data();
+    out.pay_script_hash = bytes.size() == 3u + short_hash_size &&
+        data[0] == hash160 && data[1] == push_20 &&
+        data[bytes.size() - 1] == equal;
+
+    // The embedded script is the data of the last push, which is counted
+    // (where the prevout is p2sh) only if the script is a relaxed push.
+    if (!embedded && !bytes.empty() && out.relaxed_push)
+    {
+        const auto script = data + last_push;
+        const auto embedded_script = data_slice(script, script + last_size);
+        out.embedded_sigops = analyze_bytes(embedded_script, true)
+            .accurate_sigops;
     }
 
-    // Move new inputs to new transaction and drop outputs.
-    return transaction(tx.version(), tx.locktime(), std::move(ins),
-        output::list{}).hash(sighash_type);
+    return out;
 }
 
-static hash_digest sign_single(const transaction& tx, uint32_t input_index,
-    const script& script_code, uint8_t sighash_type)
+// Concurrent analyses race to publish as with operations.
+const script::analysis& script::analyze() const
 {
-    input::list ins;
-    const auto& inputs = tx.inputs();
-    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
-    ins.reserve(any ? 1 : inputs.size());
+    const auto cached = std::atomic_load(&analysis_);
 
-    BITCOIN_ASSERT(input_index < inputs.size());
-    const auto& self = inputs[input_index];
+    if (cached)
+        return *cached;
 
-    if (any)
+    analysis_ptr expected;
+    analysis_ptr desired(std::make_shared<const analysis>(
+        analyze_bytes(bytes_, false)));
+
+    if (!std::atomic_compare_exchange_strong(&analysis_, &expected, desired))
+        return *expected;
+
+    return *desired;
+}
+
+// Signing.
+//-----------------------------------------------------------------------------
+
+// The serialized size of the nominal (non-minimal) push of the endorsement if
+// the script has that push at position, otherwise zero. The value is not
+// serialized in order to compare it.
+static size_t push_size(data_slice script, size_t position,
+    data_slice endorsement)
+{
+    const auto size = endorsement.size();
+    const auto code = operation::opcode_from_size(size);
+    size_t prefix = sizeof(uint8_t);
+
+    switch (code)
     {
-        // Retain only self.
-        ins.emplace_back(self.previous_output(), script_code, self.sequence());
+        case opcode::push_one_size:
+            prefix += sizeof(uint8_t);
+            break;
+        case opcode::push_two_size:
+            prefix += sizeof(uint16_t);
+            break;
+        case opcode::push_four_size:
+            prefix += sizeof(uint32_t);
+            break;
+        default:
+            break;
     }
-    else
-    {
-        // Erase all input scripts and sequences.
-        for (const auto& input: inputs)
-            ins.emplace_back(input.previous_output(), script{}, 0);
 
-        // Replace self that is lost in the loop.
-        ins[input_index].set_script(script_code);
-        ins[input_index].set_sequence(self.sequence());
-    }
+    const auto start = script.begin() + position;
 
-    // Trim and clear outputs except that of specified input index.
-    const auto& outputs = tx.outputs();
-    output::list outs(input_index + 1);
+    if (script.size() - position < prefix + size ||
+        *start != static_cast<uint8_t>(code))
+        return 0;
 
-    BITCOIN_ASSERT(input_index < outputs.size());
-    outs.back() = outputs[input_index];
+    // A size not encoded in the code follows it in little-endian order.
+    for (size_t byte = 1; byte < prefix; ++byte)
+        if (start[byte] != static_cast<uint8_t>(size >> (8 * (byte - 1))))
+            return 0;
 
-    // Move new inputs and new outputs to new transaction.
-    return transaction(tx.version(), tx.locktime(), std::move(ins),
-        std::move(outs)).hash(sighash_type);
+    return std::equal(endorsement.begin(), endorsement.end(), start + prefix) ?
+        prefix + size : 0;
 }
 
-static hash_digest sign_all(const transaction& tx, uint32_t input_index,
-    const script& script_code, uint8_t sighash_type)
-{
-    input::list ins;
-    const auto& inputs = tx.inputs();
-    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
-    ins.reserve(any ? 1 : inputs.size());
+//*****************************************************************************
+// CONSENSUS: find_and_delete is a pointless, broken, premature optimization
+// attempt. The comparison and erase are not limited to a single operation
+// and so can erase arbitrary upstream data from the script.
+//*****************************************************************************
+// Deletion only occurs at operation boundaries and only of whole operations,
+// so deleting all endorsements in one pass is equivalent to deleting each in
+// turn, and the operations that remain are those of the original script.
+// Stripping code separators from the result is therefore the same pass.
+static data_chunk delete_and_strip(data_slice script, const data_slice* first,
+    const data_slice* last, bool strip)
+{
+    opcode code;
+    size_t size;
+    size_t position = 0;
+    const auto begin = script.begin();
 
-    BITCOIN_ASSERT(input_index < inputs.size());
-    const auto& self = inputs[input_index];
+    data_chunk out;
+    out.reserve(script.size());
 
-    if (any)
+    while (position < script.size())
     {
-        // Retain only self.
-        ins.emplace_back(self.previous_output(), script_code, self.sequence());
-    }
-    else
-    {
-        // Erase all input scripts.
-        for (const auto& input: inputs)
-            ins.emplace_back(input.previous_output(), script{},
-                input.sequence());
-
-        // Replace self that is lost in the loop.
-        ins[input_index].set_script(script_code);
-        ////ins[input_index].set_sequence(self.sequence());
+        auto deleted = false;
+
+        // An empty endorsement would produce an empty script, not operation.
+        for (auto it = first; !deleted && it != last; ++it)
+        {
+            const auto found = it->empty() ? 0 : push_size(script, position,
+                *it);
+
+            position += found;
+            deleted = (found != 0);
+        }
+
+        if (deleted)
+            continue;
+
+        const auto start = position;
+
+        // An invalid operation ends the script. Deletion retains its bytes,
+        // but a stripped script is reserialized from decoded operations.
+        if (!bytecode::read(code, size, position, script))
+        {
+            const auto invalid = operation().to_data();
+
+            if (strip)
+                out.insert(out.end(), invalid.begin(), invalid.end());
+            else
+                out.insert(out.end(), begin + start, script.end());
+
+            break;
+        }
+
+        position += size;
+
+        if (!strip || code != opcode::codeseparator)
+            out.insert(out.end(), begin + start, begin + position);
     }
 
-    // Move new inputs and copy outputs to new transaction.
-    transaction out(tx.version(), tx.locktime(), input::list{}, tx.outputs());
-    out.set_inputs(std::move(ins));
-    return out.hash(sighash_type);
+    return out;
 }
 
-static script strip_code_seperators(const script& script_code)
+// static
+data_chunk script::to_script_code(data_slice subscript,
+    data_slice endorsement)
 {
-    operation::list ops;
-
-    for (auto op = script_code.begin(); op != script_code.end(); ++op)
-        if (op->code() != opcode::codeseparator)
-            ops.push_back(*op);
+    return delete_and_strip(subscript, &endorsement, &endorsement + 1, true);
+}
 
-    return script(std::move(ops));
+// static
+data_chunk script::to_script_code(data_slice subscript,
+    const std::vector<data_slice>& endorsements)
+{
+    const auto first = endorsements.data();
+    return delete_and_strip(subscript, first, first + endorsements.size(),
+        true);
 }
 
 // static
@@ -622,39 +688,26 @@ static script strip_code_seperators(const script& script_code)
 hash_digest script::generate_signature_hash(const transaction& tx,
     uint32_t input_index, const script& script_code, uint8_t sighash_type)
 {
-    const auto sighash = to_sighash_enum(sighash_type);
-
-    if (input_index >= tx.inputs().size() ||
-        (input_index >= tx.outputs().size() &&
-            sighash == sighash_algorithm::single))
-    {
-        //*********************************************************************
-        // CONSENSUS: wacky satoshi behavior we must perpetuate.
-        //*********************************************************************
-        return one_hash;
-    }
-
     //*************************************************************************
-    // CONSENSUS: more wacky satoshi behavior we must perpetuate.
+    // CONSENSUS: wacky satoshi behavior we must perpetuate.
     //*************************************************************************
-    const auto stripped = strip_code_seperators(script_code);
+    const auto stripped = delete_and_strip(script_code.bytes(), nullptr,
+        nullptr, true);
 
-    // The sighash serializations are isolated for clarity and optimization.
-    switch (sighash)
-    {
-        case sighash_algorithm::none:
-            return sign_none(tx, input_index, stripped, sighash_type);
-        case sighash_algorithm::single:
-            return sign_single(tx, input_index, stripped, sighash_type);
-        default:
-        case sighash_algorithm::all:
-            return sign_all(tx, input_index, stripped, sighash_type);
-    }
+    return generate_signature_hash(tx, input_index, stripped, sighash_type);
+}
+
+// static
+hash_digest script::generate_signature_hash(const transaction& tx,
+    uint32_t input_index, data_slice script_code, uint8_t sighash_type)
+{
+    // The transaction invariants are serialized once, across all inputs.
+    return tx.sighash()->hash(input_index, script_code, sighash_type);
 }
 
 // static
 bool script::check_signature(const ec_signature& signature,
-    uint8_t sighash_type, const data_chunk& public_key,
+    uint8_t sighash_type, data_slice public_key,
     const script& script_code, const transaction& tx, uint32_t input_index)
 {
     if (public_key.empty())
@@ -668,6 +721,22 @@ bool script::check_signature(const ec_signature& signature,
     return verify_signature(public_key, sighash, signature);
 }
 
+// static
+bool script::check_signature(const ec_signature& signature,
+    uint8_t sighash_type, data_slice public_key, data_slice script_code,
+    const transaction& tx, uint32_t input_index)
+{
+    if (public_key.empty())
+        return false;
+
+    // This always produces a valid signature hash, including one_hash.
+    const auto sighash = script::generate_signature_hash(tx, input_index,
+        script_code, sighash_type);
+
+    // Validate the EC signature.
+    return verify_signature(public_key, sighash, signature);
+}
+
 // static
 bool script::create_endorsement(endorsement& out, const ec_secret& secret,
     const script& prevout_script, const transaction& tx, uint32_t input_index,
@@ -956,20 +1025,21 @@ script_pattern script::pattern() const
 // Output patterns are mutually and input unambiguous.
 script_pattern script::output_pattern() const
 {
-    // The first operations access must be method-based to guarantee the cache.
-    if (is_pay_key_hash_pattern(operations()))
+    const auto& ops = operations();
+
+    if (is_pay_key_hash_pattern(ops))
         return script_pattern::pay_key_hash;
 
-    if (is_pay_script_hash_pattern(operations_))
+    if (is_pay_script_hash_pattern(ops))
         return script_pattern::pay_script_hash;
 
-    if (is_pay_null_data_pattern(operations_))
+    if (is_pay_null_data_pattern(ops))
         return script_pattern::pay_null_data;
 
-    if (is_pay_public_key_pattern(operations_))
+    if (is_pay_public_key_pattern(ops))
         return script_pattern::pay_public_key;
 
-    if (is_pay_multisig_pattern(operations_))
+    if (is_pay_multisig_pattern(ops))
         return script_pattern::pay_multisig;
 
     return script_pattern::non_standard;
@@ -979,18 +1049,19 @@ script_pattern script::output_pattern() const
 // The bip34 coinbase pattern is not tested here, must test independently.
 script_pattern script::input_pattern() const
 {
-    // The first operations access must be method-based to guarantee the cache.
-    if (is_sign_key_hash_pattern(operations()))
+    const auto& ops = operations();
+
+    if (is_sign_key_hash_pattern(ops))
         return script_pattern::sign_key_hash;
 
     // This must follow is_sign_key_hash_pattern for ambiguity comment to hold.
-    if (is_sign_script_hash_pattern(operations_))
+    if (is_sign_script_hash_pattern(ops))
         return script_pattern::sign_script_hash;
 
-    if (is_sign_public_key_pattern(operations_))
+    if (is_sign_public_key_pattern(ops))
         return script_pattern::sign_public_key;
 
-    if (is_sign_multisig_pattern(operations_))
+    if (is_sign_multisig_pattern(ops))
         return script_pattern::sign_multisig;
 
     return script_pattern::non_standard;
@@ -999,117 +1070,35 @@ script_pattern script::input_pattern() const
 bool script::is_pay_to_script_hash(uint32_t forks) const
 {
     // This is used internally as an optimization over using script::pattern.
-    // The prevout operations access must be method-based to guarantee the cache.
     return is_enabled(forks, rule_fork::bip16_rule) &&
-        is_pay_script_hash_pattern(operations());
-}
-
-inline size_t ops(bool embedded, opcode code)
-{
-    return embedded && operation::is_positive(code) ?
-        operation::opcode_to_positive(code) : multisig_default_sigops;
+        analyze().pay_script_hash;
 }
 
 size_t script::sigops(bool embedded) const
 {
-    size_t total = 0;
-    auto preceding = opcode::push_negative_1;
-
-    // The first operations access must be method-based to guarantee the cache.
-    for (const auto& op: operations())
-    {
-        const auto code = op.code();
-
-        if (code == opcode::checksig ||
-            code == opcode::checksigverify)
-        {
-            ++total;
-        }
-        else if (
-            code == opcode::checkmultisig ||
-            code == opcode::checkmultisigverify)
-        {
-            total += ops(embedded, preceding);
-        }
-
-        preceding = code;
-    }
-
-    return total;
+    const auto& properties = analyze();
+    return embedded ? properties.accurate_sigops : properties.sigops;
 }
 
 size_t script::embedded_sigops(const script& prevout_script) const
 {
     // There are no embedded sigops when the prevout script is not p2sh.
-    if (!prevout_script.is_pay_to_script_hash(rule_fork::bip16_rule))
-        return 0;
-
-    // The first operations access must be method-based to guarantee the cache.
-    if (operations().empty())
-        return 0;
-
-    // There are no embedded sigops when the input script is not push only.
-    if (!is_relaxed_push(operations_))
-        return 0;
-
-    // Parse the embedded script from the last input script item (data).
-    // This never fails because there is no prefix to validate the length.
-    script embedded(operations_.back().data(), false);
-
-    // Count the sigops in the embedded script using BIP16 rules.
-    return embedded.sigops(true);
-}
-
-//*****************************************************************************
-// CONSENSUS: this is a pointless, broken, premature optimization attempt.
-// The comparison and erase are not limited to a single operation and so can
-// erase arbitrary upstream data from the script.
-//*****************************************************************************
-void script::find_and_delete_(const data_chunk& endorsement)
-{
-    // If this is empty it would produce an empty script but not operation.
-    // So we test it for empty prior to operation reserialization.
-    if (endorsement.empty())
-        return;
-
-    // The value must be serialized to script using non-minimal encoding.
-    // Non-minimally-encoded target values will therefore not match.
-    const auto value = operation(endorsement, false).to_data();
-
-    operation op;
-    data_source stream(bytes_);
-    istream_reader source(stream);
-    std::vector<data_chunk::iterator> found;
-
-    // The exhaustion test handles stream end and op deserialization failure.
-    for (auto it = bytes_.begin(); !source.is_exhausted();
-        it += op.serialized_size())
-    {
-        // Track all found values for later deletion.
-        for (; starts_with(it, bytes_.end(), value); it += value.size())
-        {
-            source.skip(value.size());
-            found.push_back(it);
-        }
-
-        // Read the next op code following last found value.
-        op.from_data(source);
-    }
-
-    // Delete any found values, reversed to prevent iterator invalidation.
-    for (const auto it: reverse(found))
-        bytes_.erase(it, it + value.size());
+    return prevout_script.is_pay_to_script_hash(rule_fork::bip16_rule) ?
+        analyze().embedded_sigops : 0;
 }
 
 // Concurrent read/write is not supported, so no critical section.
 void script::find_and_delete(const data_stack& endorsements)
 {
-    for (auto& endorsement: endorsements)
-        find_and_delete_(endorsement);
+    const std::vector<data_slice> values(endorsements.begin(),
+        endorsements.end());
 
-    // Invalidate the cache so that the operations may be regenerated.
-    operations_.clear();
-    cached_ = false;
+    const auto first = values.data();
+    bytes_ = delete_and_strip(bytes_, first, first + values.size(), false);
+
+    // Invalidate the caches so that they may be regenerated.
+    operations_.reset();
+    analysis_.reset();
     bytes_.shrink_to_fit();
 }
 
@@ -1132,8 +1121,9 @@ void script::find_and_delete(const data_stack& endorsements)
 // The criteria below are not be comprehensive but are fast to evaluate.
 bool script::is_unspendable() const
 {
-    // The first operations access must be method-based to guarantee the cache.
-    return (!operations().empty() && operations_[0].code() == opcode::return_)
+    // The first byte is the code of the first operation, avoiding a decode.
+    static const auto return_code = static_cast<uint8_t>(opcode::return_);
+    return (!bytes_.empty() && bytes_.front() == return_code)
         || satoshi_content_size() > max_script_size;
 }
 
@@ -1145,7 +1135,20 @@ code script::verify(const transaction& tx, uint32_t input_index,
 {
     code ec;
 
-    program input(input_script, tx, input_index, forks);
+    if (verify_template(ec, tx, input_index, forks, input_script,
+        prevout_script))
+        return ec;
+
+    return evaluate(tx, input_index, forks, input_script, prevout_script);
+}
+
+code script::evaluate(const transaction& tx, uint32_t input_index,
+    uint32_t forks, const script& input_script, const script& prevout_script,
+    bool deferred, evaluation_trace* trace)
+{
+    code ec;
+
+    program input(input_script, tx, input_index, forks, deferred, trace);
     if ((ec = input.evaluate()))
         return ec;
 
@@ -1158,11 +1161,11 @@ code script::verify(const transaction& tx, uint32_t input_index,
 
     if (prevout_script.is_pay_to_script_hash(forks))
     {
-        if (!is_relaxed_push(input_script.operations()))
+        if (!input_script.analyze().relaxed_push)
             return error::invalid_script_embed;
 
         // The embedded p2sh script is at the top of the stack.
-        script embedded_script(input.pop(), false);
+        script embedded_script(to_chunk(input.pop()), false);
 
         program embedded(embedded_script, std::move(input), true);
         if ((ec = embedded.evaluate()))
@@ -1175,6 +1178,264 @@ code script::verify(const transaction& tx, uint32_t input_index,
     return error::success;
 }
 
+// Template fast paths.
+//-----------------------------------------------------------------------------
+// These produce the result of evaluation for the common templates without
+// constructing programs. Any deviation from the template defers to evaluation.
+
+static BC_CONSTEXPR auto op_78 = static_cast<uint8_t>(opcode::push_four_size);
+
+inline bool is_payload(const bytecode::instruction& instruction)
+{
+    return static_cast<uint8_t>(instruction.code) <= op_78;
+}
+
+inline data_chunk to_payload(const data_chunk& bytes,
+    const bytecode::instruction& instruction)
+{
+    const auto begin = bytes.begin() + instruction.offset;
+    return data_chunk(begin, begin + instruction.size);
+}
+
+// The payloads of a script consisting only of data pushes, in script order.
+static bool to_payloads(data_stack& out, const script& script)
+{
+    const auto& bytes = script.bytes();
+
+    if (bytes.size() > max_script_size)
+        return false;
+
+    const auto compiled = bytecode::compile(bytes);
+
+    if (!compiled->is_valid() || compiled->is_disabled())
+        return false;
+
+    out.reserve(compiled->instructions().size());
+
+    for (const auto& instruction: compiled->instructions())
+    {
+        if (!is_payload(instruction))
+            return false;
+
+        out.push_back(to_payload(bytes, instruction));
+    }
+
+    return true;
+}
+
+// A script code push equal to an endorsement would be removed by
+// find_and_delete, in which case the script code is not the script.
+static bool is_deletable(const data_chunk& endorsement,
+    const data_stack& pushes)
+{
+    return !endorsement.empty() &&
+        std::find(pushes.begin(), pushes.end(), endorsement) != pushes.end();
+}
+
+// This mirrors interpreter::op_check_sig_verify.
+// Template script code has no code separators or deletable endorsements.
+static code check_endorsement(data_chunk&& endorsement,
+    const data_chunk& public_key, data_slice script_code,
+    const transaction& tx, uint32_t input_index, bool strict,
+    evaluation_trace* trace)
+{
+    uint8_t sighash;
+    ec_signature signature;
+    der_signature distinguished;
+
+    if (!parse_endorsement(sighash, distinguished, std::move(endorsement)))
+        return error::invalid_signature_encoding;
+
+    if (!parse_signature(signature, distinguished, strict))
+        return strict ? error::invalid_signature_lax_encoding :
+            error::invalid_signature_encoding;
+
+    if (trace != nullptr && !public_key.empty())
+        ++trace->signature_hashes;
+
+    return script::check_signature(signature, sighash, public_key,
+        script_code, tx, input_index) ? error::success :
+            error::incorrect_signature;
+}
+
+// Input: [endorsement] [public key]
+// Prevout: dup hash160 [hash] equalverify checksig
+static bool verify_pay_key_hash(code& out, const transaction& tx,
+    uint32_t input_index, uint32_t forks, const script& input_script,
+    const script& prevout_script, evaluation_trace* trace)
+{
+    data_stack input;
+    if (!to_payloads(input, input_script) || input.size() != 2)
+        return false;
+
+    auto& endorsement = input.front();
+    const auto& public_key = input.back();
+    const auto& prevout = prevout_script.bytes();
+    const auto begin = prevout.begin() + 3;
+    const auto end = begin + short_hash_size;
+    const auto key_hash = bitcoin_short_hash(public_key);
+
+    if (!std::equal(begin, end, key_hash.begin()))
+    {
+        out = error::op_equal_verify2;
+        return true;
+    }
+
+    if (is_deletable(endorsement, { data_chunk(begin, end) }))
+        return false;
+
+    const auto strict = script::is_enabled(forks, rule_fork::bip66_rule);
+    const auto verified = check_endorsement(std::move(endorsement),
+        public_key, prevout, tx, input_index, strict, trace);
+
+    // BIP62: only lax encoding fails the operation.
+    if (verified == error::invalid_signature_lax_encoding)
+        out = error::op_check_sig;
+    else
+        out = verified ? error::stack_false : error::success;
+
+    return true;
+}
+
+// Input: [dummy] [endorsement]... [redeem]
+// Prevout: hash160 [hash] equal
+// Redeem: m [public key]... n checkmultisig
+static bool verify_pay_script_hash(code& out, const transaction& tx,
+    uint32_t input_index, uint32_t forks, const script& input_script,
+    const script& prevout_script, evaluation_trace* trace)
+{
+    data_stack input;
+    if (!to_payloads(input, input_script) || input.empty())
+        return false;
+
+    const auto& prevout = prevout_script.bytes();
+    const auto begin = prevout.begin() + 2;
+    const auto script_hash = bitcoin_short_hash(input.back());
+    const auto matched = std::equal(begin, begin + short_hash_size,
+        script_hash.begin());
+
+    // Prior to bip16 the prevout only compares the redeem script hash.
+    if (!matched || !script::is_enabled(forks, rule_fork::bip16_rule))
+    {
+        out = matched ? error::success : error::stack_false;
+        return true;
+    }
+
+    const script redeem_script(input.back(), false);
+    const auto& redeem = redeem_script.bytes();
+    const auto compiled = bytecode::compile(redeem);
+    const auto& instructions = compiled->instructions();
+    const auto count = instructions.size();
+
+    if (!compiled->is_valid() || compiled->is_disabled() || count < 3 ||
+        instructions.back().code != opcode::checkmultisig ||
+        !operation::is_positive(instructions.front().code) ||
+        !operation::is_positive(instructions[count - 2].code))
+        return false;
+
+    const size_t signatures =
+        operation::opcode_to_positive(instructions.front().code);
+    const size_t keys =
+        operation::opcode_to_positive(instructions[count - 2].code);
+
+    // Otherwise the stack is not consumed as the template expects.
+    if (keys != count - 3 || signatures > keys ||
+        input.size() != signatures + 2)
+        return false;
+
+    // Keys and endorsements are in stack (reverse script) order.
+    data_stack public_keys;
+    public_keys.reserve(keys);
+
+    for (auto it = instructions.rbegin() + 2; it != instructions.rend() - 1;
+        ++it)
+    {
+        if (!is_payload(*it))
+            return false;
+
+        public_keys.push_back(to_payload(redeem, *it));
+    }
+
+    data_stack endorsements(input.rbegin() + 1, input.rend() - 1);
+
+    for (const auto& endorsement: endorsements)
+        if (is_deletable(endorsement, public_keys))
+            return false;
+
+    // This mirrors interpreter::op_check_multisig_verify.
+    code verified(error::success);
+    auto public_key = public_keys.begin();
+    const auto strict = script::is_enabled(forks, rule_fork::bip66_rule);
+
+    for (auto& endorsement: endorsements)
+    {
+        uint8_t sighash;
+        ec_signature signature;
+        der_signature distinguished;
+
+        if (!parse_endorsement(sighash, distinguished, std::move(endorsement)))
+        {
+            verified = error::invalid_signature_encoding;
+            break;
+        }
+
+        if (!parse_signature(signature, distinguished, strict))
+        {
+            verified = strict ? error::invalid_signature_lax_encoding :
+                error::invalid_signature_encoding;
+            break;
+        }
+
+        // The signature hash is shared by all keys tried for the endorsement.
+        const auto hash = script::generate_signature_hash(tx, input_index,
+            redeem, sighash);
+
+        if (trace != nullptr)
+            ++trace->signature_hashes;
+
+        while (public_key->empty() ||
+            !verify_signature(*public_key, hash, signature))
+        {
+            if (++public_key == public_keys.end())
+            {
+                verified = error::incorrect_signature;
+                break;
+            }
+        }
+
+        if (verified)
+            break;
+    }
+
+    // BIP62: only lax encoding fails the operation.
+    if (verified == error::invalid_signature_lax_encoding)
+        out = error::op_check_multisig;
+    else
+        out = verified ? error::stack_false : error::success;
+
+    return true;
+}
+
+bool script::verify_template(code& out, const transaction& tx,
+    uint32_t input_index, uint32_t forks, const script& input_script,
+    const script& prevout_script, evaluation_trace* trace)
+{
+    // Standard output templates are recognized by compilation (memoized).
+    const auto prevout = bytecode::compile(prevout_script.bytes());
+
+    switch (prevout->pattern())
+    {
+        case script_pattern::pay_key_hash:
+            return verify_pay_key_hash(out, tx, input_index, forks,
+                input_script, prevout_script, trace);
+        case script_pattern::pay_script_hash:
+            return verify_pay_script_hash(out, tx, input_index, forks,
+                input_script, prevout_script, trace);
+        default:
+            return false;
+    }
+}
+
 code script::verify(const transaction& tx, uint32_t input, uint32_t forks)
 {
     if (input >= tx.inputs().size())
@@ -1185,5 +1446,29 @@ code script::verify(const transaction& tx, uint32_t input, uint32_t forks)
     return verify(tx, input, forks, in.script(), prevout.script());
 }
 
+code script::verify(const transaction& tx, uint32_t input, uint32_t forks,
+    evaluation_trace& trace)
+{
+    if (input >= tx.inputs().size())
+        return error::operation_failed;
+
+    code ec;
+    const auto& in = tx.inputs()[input];
+    const auto& prevout = in.previous_output().validation.cache;
+    const auto start = asio::steady_clock::now();
+
+    trace.hash = tx.hash();
+    trace.index = input;
+    trace.templated = verify_template(ec, tx, input, forks, in.script(),
+        prevout.script(), &trace);
+
+    if (!trace.templated)
+        ec = evaluate(tx, input, forks, in.script(), prevout.script(), false,
+            &trace);
+
+    trace.duration = asio::steady_clock::now() - start;
+    return ec;
+}
+
 } // namespace chain
 } // namespace libbitcoin
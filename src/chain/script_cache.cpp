@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/random.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// The salt fills one sha256 block, so each key hashes from its midstate.
+static constexpr size_t salt_size = 64;
+
+static sha256_context salted_context()
+{
+    data_chunk salt(salt_size);
+    pseudo_random_fill(salt);
+
+    sha256_context context;
+    context.write(salt);
+    return context;
+}
+
+script_cache::script_cache(size_t capacity)
+  : capacity_(capacity),
+    salted_(salted_context()),
+    hits_(0),
+    misses_(0),
+    next_(0)
+{
+    entries_.reserve(capacity_);
+    order_.reserve(capacity_);
+}
+
+hash_digest script_cache::key(const transaction& tx, uint32_t input_index,
+    uint32_t forks) const
+{
+    auto context = salted_;
+    context.write(tx.hash());
+    context.write(to_little_endian(input_index));
+    context.write(to_little_endian(forks));
+    return context.finalize();
+}
+
+bool script_cache::contains(const transaction& tx, uint32_t input_index,
+    uint32_t forks) const
+{
+    const auto entry = key(tx, input_index, forks);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    const auto found = entries_.find(entry) != entries_.end();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+        ++hits_;
+    else
+        ++misses_;
+
+    return found;
+}
+
+void script_cache::store(const transaction& tx, uint32_t input_index,
+    uint32_t forks)
+{
+    if (capacity_ == 0)
+        return;
+
+    const auto entry = key(tx, input_index, forks);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    if (entries_.find(entry) != entries_.end())
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // Evict the oldest entry once full, replacing it in the order.
+    if (order_.size() < capacity_)
+    {
+        order_.push_back(entry);
+    }
+    else
+    {
+        entries_.erase(order_[next_]);
+        order_[next_] = entry;
+    }
+
+    next_ = (next_ + 1) % capacity_;
+    entries_.insert(entry);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t script_cache::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    const auto size = entries_.size();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return size;
+}
+
+size_t script_cache::capacity() const
+{
+    return capacity_;
+}
+
+size_t script_cache::hits() const
+{
+    return hits_;
+}
+
+size_t script_cache::misses() const
+{
+    return misses_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/sighash_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/formats/base_16.hpp>
+#include <bitcoin/bitcoin/machine/sighash_algorithm.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::machine;
+
+// bit.ly/2cPazSa
+static const auto one_hash = hash_literal(
+    "0000000000000000000000000000000000000000000000000000000000000001");
+
+// Point (hash and index), empty script (zero size) and sequence.
+static BC_CONSTEXPR size_t point_size = hash_size + sizeof(uint32_t);
+static BC_CONSTEXPR size_t record_size = point_size + 1 + sizeof(uint32_t);
+
+// The value (not_found) and empty script of a default output.
+static const byte_array<sizeof(uint64_t) + 1> null_output
+{
+    {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00
+    }
+};
+
+static void write_variable(sha256_context& context, uint64_t value)
+{
+    byte_array<sizeof(uint8_t) + sizeof(uint64_t)> buffer;
+    auto sink = make_unsafe_serializer(buffer.begin());
+    sink.write_variable_little_endian(value);
+    const auto size = message::variable_uint_size(value);
+    context.write({ buffer.data(), buffer.data() + size });
+}
+
+static size_t outputs_size(const transaction& tx)
+{
+    size_t size = 0;
+
+    for (const auto& output: tx.outputs())
+        size += output.serialized_size(true);
+
+    return size;
+}
+
+sighash_cache::sighash_cache(const transaction& tx)
+  : inputs_(tx.inputs().size()),
+    outputs_(tx.outputs().size()),
+    version_(to_chunk(to_little_endian(tx.version()))),
+    locktime_(to_chunk(to_little_endian(tx.locktime()))),
+    records_(inputs_ * record_size),
+    zeroed_(inputs_ * record_size),
+    serialized_outputs_(outputs_size(tx))
+{
+    auto records = make_unsafe_serializer(records_.begin());
+    auto zeroed = make_unsafe_serializer(zeroed_.begin());
+
+    for (const auto& input: tx.inputs())
+    {
+        input.previous_output().to_data(records, true);
+        records.write_byte(0);
+        records.write_4_bytes_little_endian(input.sequence());
+
+        input.previous_output().to_data(zeroed, true);
+        zeroed.write_byte(0);
+        zeroed.write_4_bytes_little_endian(0);
+    }
+
+    size_t offset = 0;
+    offsets_.reserve(outputs_ + 1);
+    auto outputs = make_unsafe_serializer(serialized_outputs_.begin());
+
+    for (const auto& output: tx.outputs())
+    {
+        offsets_.push_back(offset);
+        offset += output.serialized_size(true);
+        output.to_data(outputs, true);
+    }
+
+    offsets_.push_back(offset);
+    BITCOIN_ASSERT(offset == serialized_outputs_.size());
+
+    sha256_context prefix;
+    prefix.write(version_);
+    write_variable(prefix, inputs_);
+
+    auto records_context = prefix;
+    auto zeroed_context = prefix;
+    records_midstates_.reserve(inputs_);
+    zeroed_midstates_.reserve(inputs_);
+
+    for (size_t index = 0; index < inputs_; ++index)
+    {
+        const auto start = index * record_size;
+        records_midstates_.push_back(records_context);
+        zeroed_midstates_.push_back(zeroed_context);
+        records_context.write({ &records_[start], &records_[start] +
+            record_size });
+        zeroed_context.write({ &zeroed_[start], &zeroed_[start] +
+            record_size });
+    }
+}
+
+void sighash_cache::write_outputs(sha256_context& context,
+    uint32_t input_index, uint8_t sighash_type) const
+{
+    switch (sighash_type & sighash_algorithm::mask)
+    {
+        case sighash_algorithm::none:
+        {
+            write_variable(context, 0);
+            return;
+        }
+        case sighash_algorithm::single:
+        {
+            // Outputs preceding that of the input index are defaulted.
+            write_variable(context, input_index + 1);
+
+            for (uint32_t index = 0; index < input_index; ++index)
+                context.write(null_output);
+
+            const auto begin = serialized_outputs_.data();
+            context.write({ begin + offsets_[input_index],
+                begin + offsets_[input_index + 1] });
+            return;
+        }
+        default:
+        {
+            write_variable(context, outputs_);
+            context.write(serialized_outputs_);
+            return;
+        }
+    }
+}
+
+hash_digest sighash_cache::hash(uint32_t input_index, data_slice script_code,
+    uint8_t sighash_type) const
+{
+    const auto algorithm = sighash_type & sighash_algorithm::mask;
+    const auto single = algorithm == sighash_algorithm::single;
+    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
+
+    // Sequences of other inputs are zeroed under the none and single types.
+    const auto all = !single && algorithm != sighash_algorithm::none;
+
+    if (input_index >= inputs_ || (input_index >= outputs_ && single))
+    {
+        //*********************************************************************
+        // CONSENSUS: wacky satoshi behavior we must perpetuate.
+        //*********************************************************************
+        return one_hash;
+    }
+
+    const auto& records = all ? records_ : zeroed_;
+    const auto record = &records_[input_index * record_size];
+    const auto sequence = record + point_size + 1;
+    sha256_context context;
+
+    if (any)
+    {
+        // Retain only self.
+        context.write(version_);
+        write_variable(context, 1);
+    }
+    else
+    {
+        // Resume from the midstate that precedes self.
+        context = all ? records_midstates_[input_index] :
+            zeroed_midstates_[input_index];
+    }
+
+    // Self retains its sequence and obtains the script code.
+    context.write({ record, record + point_size });
+    write_variable(context, script_code.size());
+    context.write(script_code);
+    context.write({ sequence, sequence + sizeof(uint32_t) });
+
+    if (!any)
+    {
+        const auto begin = records.data();
+        context.write({ begin + (input_index + 1) * record_size,
+            begin + records.size() });
+    }
+
+    write_outputs(context, input_index, sighash_type);
+    context.write(locktime_);
+    context.write(to_little_endian<uint32_t>(sighash_type));
+    return sha256_hash(context.finalize());
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -32,16 +32,19 @@
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/machine/trace_collector.hpp>
 #include <bitcoin/bitcoin/message/messages.hpp>
 #include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/endian.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
@@ -207,10 +210,11 @@ bool transaction::operator!=(const transaction& other) const
 //-----------------------------------------------------------------------------
 
 // static
-transaction transaction::factory(const data_chunk& data, bool wire)
+transaction transaction::factory(const data_chunk& data, bool wire,
+    bool hash)
 {
     transaction instance;
-    instance.from_data(data, wire);
+    instance.from_data(data, wire, hash);
     return instance;
 }
 
@@ -247,10 +251,18 @@ transaction transaction::factory(reader& source,
     return instance;
 }
 
-bool transaction::from_data(const data_chunk& data, bool wire)
+bool transaction::from_data(const data_chunk& data, bool wire, bool hash)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+
+    if (!from_data(source, wire))
+        return false;
+
+    // The txid covers only the wire serialization.
+    if (hash && wire)
+        cache_hash({ data.data(), data.data() + serialized_size(true) });
+
+    return true;
 }
 
 bool transaction::from_data(std::istream& stream, bool wire)
@@ -290,16 +302,24 @@ bool transaction::from_data(reader& source, bool wire)
     return source;
 }
 
+// The hash is set after parse, as reset clears the cache.
 bool transaction::from_data(reader& source, hash_digest&& hash)
 {
+    if (!from_data(source, false))
+        return false;
+
     hash_ = std::make_shared<hash_digest>(std::move(hash));
-    return from_data(source, false);
+    return true;
 }
 
+// The hash is set after parse, as reset clears the cache.
 bool transaction::from_data(reader& source, const hash_digest& hash)
 {
+    if (!from_data(source, false))
+        return false;
+
     hash_ = std::make_shared<hash_digest>(hash);
-    return from_data(source, false);
+    return true;
 }
 
 // protected
@@ -316,6 +336,12 @@ void transaction::reset()
     total_output_value_ = boost::none;
 }
 
+// protected
+void transaction::cache_hash(data_slice wire)
+{
+    hash_ = std::make_shared<hash_digest>(bitcoin_hash(wire));
+}
+
 bool transaction::is_valid() const
 {
     return (version_ != 0) || (locktime_ != 0) || !inputs_.empty() ||
@@ -472,11 +498,12 @@ void transaction::invalidate_cache() const
     // Critical Section
     mutex_.lock_upgrade();
 
-    if (hash_)
+    if (hash_ || sighash_)
     {
         mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_.reset();
+        sighash_.reset();
         //---------------------------------------------------------------------
         mutex_.unlock_and_lock_upgrade();
     }
@@ -514,6 +541,28 @@ hash_digest transaction::hash(uint32_t sighash_type) const
     return bitcoin_hash(serialized);
 }
 
+sighash_cache::ptr transaction::sighash() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    if (!sighash_)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+        sighash_ = std::make_shared<const sighash_cache>(*this);
+        mutex_.unlock_and_lock_upgrade();
+        //---------------------------------------------------------------------
+    }
+
+    const auto sighash = sighash_;
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return sighash;
+}
+
 // Validation helpers.
 //-----------------------------------------------------------------------------
 
@@ -790,9 +839,17 @@ bool transaction::is_mature(size_t height) const
     return std::all_of(inputs_.begin(), inputs_.end(), mature);
 }
 
-// Coinbase transactions return success, to simplify iteration.
 code transaction::connect_input(const chain_state& state,
     size_t input_index) const
+{
+    return connect_input(state, input_index, validation.scripts,
+        validation.traces);
+}
+
+// Coinbase transactions return success, to simplify iteration.
+code transaction::connect_input(const chain_state& state,
+    size_t input_index, const script_cache::ptr& scripts,
+    const trace_collector::ptr& traces) const
 {
     if (input_index >= inputs_.size())
         return error::operation_failed;
@@ -809,8 +866,28 @@ code transaction::connect_input(const chain_state& state,
     const auto forks = state.enabled_forks();
     const auto index32 = static_cast<uint32_t>(input_index);
 
+    // The input was verified under the same forks (e.g. in the pool).
+    if (scripts && scripts->contains(*this, index32, forks))
+        return error::success;
+
+    code ec;
+
     // Verify the transaction input script against the previous output.
-    return script::verify(*this, index32, forks);
+    if (traces)
+    {
+        evaluation_trace trace;
+        ec = script::verify(*this, index32, forks, trace);
+        traces->collect(trace);
+    }
+    else
+    {
+        ec = script::verify(*this, index32, forks);
+    }
+
+    if (!ec && scripts)
+        scripts->store(*this, index32, forks);
+
+    return ec;
 }
 
 // Validation.
@@ -916,11 +993,18 @@ code transaction::connect() const
 }
 
 code transaction::connect(const chain_state& state) const
+{
+    return connect(state, validation.scripts, validation.traces);
+}
+
+code transaction::connect(const chain_state& state,
+    const script_cache::ptr& scripts,
+    const trace_collector::ptr& traces) const
 {
     code ec;
 
     for (size_t input = 0; input < inputs_.size(); ++input)
-        if ((ec = connect_input(state, input)))
+        if ((ec = connect_input(state, input, scripts, traces)))
             return ec;
 
     return error::success;
@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+// A standard output script shape, all instances of which compile the same.
+// Only the payload differs between instances and offsets are independent of
+// payload content, so one compiled instance is shared by all.
+class standard_shape
+{
+public:
+    standard_shape(script_pattern pattern,
+        std::initializer_list<opcode> prefix, size_t payload,
+        std::initializer_list<opcode> suffix)
+      : begin_(prefix.size()), end_(prefix.size() + payload)
+    {
+        for (const auto code: prefix)
+            model_.push_back(static_cast<uint8_t>(code));
+
+        model_.resize(end_, 0x00);
+
+        for (const auto code: suffix)
+            model_.push_back(static_cast<uint8_t>(code));
+
+        code_ = std::make_shared<const bytecode>(model_, pattern);
+    }
+
+    bool matches(const data_chunk& script) const
+    {
+        if (script.size() != model_.size())
+            return false;
+
+        for (size_t index = 0; index < begin_; ++index)
+            if (script[index] != model_[index])
+                return false;
+
+        for (size_t index = end_; index < model_.size(); ++index)
+            if (script[index] != model_[index])
+                return false;
+
+        return true;
+    }
+
+    const bytecode::ptr& code() const
+    {
+        return code_;
+    }
+
+private:
+    size_t begin_;
+    size_t end_;
+    data_chunk model_;
+    bytecode::ptr code_;
+};
+
+static const std::vector<standard_shape> standard_shapes
+{
+    { script_pattern::pay_key_hash,
+        { opcode::dup, opcode::hash160, opcode::push_size_20 }, 20,
+        { opcode::equalverify, opcode::checksig } },
+
+    { script_pattern::pay_script_hash,
+        { opcode::hash160, opcode::push_size_20 }, 20,
+        { opcode::equal } },
+
+    // Compressed public key.
+    { script_pattern::pay_public_key,
+        { opcode::push_size_33 }, 33,
+        { opcode::checksig } },
+
+    // Uncompressed public key.
+    { script_pattern::pay_public_key,
+        { opcode::push_size_65 }, 65,
+        { opcode::checksig } }
+};
+
+// Read the push data size for the code, false if the size is truncated.
+static bool read_size(size_t& out_size, size_t& position, opcode code,
+    data_slice script)
+{
+    BC_CONSTEXPR auto op_75 = static_cast<uint8_t>(opcode::push_size_75);
+    const auto remaining = script.size() - position;
+    const auto start = script.begin() + position;
+
+    switch (code)
+    {
+        case opcode::push_one_size:
+            if (remaining < sizeof(uint8_t))
+                return false;
+
+            out_size = *start;
+            position += sizeof(uint8_t);
+            return true;
+
+        case opcode::push_two_size:
+            if (remaining < sizeof(uint16_t))
+                return false;
+
+            out_size = from_little_endian_unsafe<uint16_t>(start);
+            position += sizeof(uint16_t);
+            return true;
+
+        case opcode::push_four_size:
+            if (remaining < sizeof(uint32_t))
+                return false;
+
+            out_size = from_little_endian_unsafe<uint32_t>(start);
+            position += sizeof(uint32_t);
+            return true;
+
+        default:
+            const auto value = static_cast<uint8_t>(code);
+            out_size = value <= op_75 ? value : 0;
+            return true;
+    }
+}
+
+// static
+// This mirrors operation deserialization, see script::operations.
+bool bytecode::read(opcode& out_code, size_t& out_size, size_t& position,
+    data_slice script)
+{
+    BITCOIN_ASSERT(position < script.size());
+    out_code = static_cast<opcode>(script.data()[position++]);
+
+    // Guard against potential for arbitary memory allocation.
+    return read_size(out_size, position, out_code, script) &&
+        out_size <= max_push_data_size &&
+        out_size <= script.size() - position;
+}
+
+// static
+bytecode::ptr bytecode::compile(const data_chunk& script)
+{
+    for (const auto& standard: standard_shapes)
+        if (standard.matches(script))
+            return standard.code();
+
+    return std::make_shared<const bytecode>(script);
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+bytecode::bytecode()
+  : pattern_(script_pattern::non_standard), valid_(true), disabled_(false)
+{
+}
+
+bytecode::bytecode(const data_chunk& script, script_pattern pattern)
+  : pattern_(pattern), valid_(true), disabled_(false)
+{
+    opcode code;
+    size_t size;
+    size_t position = 0;
+
+    // One instruction per byte is the upper limit of instructions.
+    instructions_.reserve(script.size());
+
+    while (position < script.size())
+    {
+        const auto start = position;
+
+        if (!read(code, size, position, script))
+        {
+            valid_ = false;
+            break;
+        }
+
+        // Parsing continues past a disabled code so that validity is known.
+        if (!disabled_ && operation::is_disabled(code))
+            disabled_ = true;
+
+        if (!disabled_)
+            instructions_.push_back(
+            {
+                code,
+                static_cast<uint32_t>(start),
+                static_cast<uint32_t>(position),
+                static_cast<uint32_t>(size)
+            });
+
+        position += size;
+    }
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool bytecode::is_valid() const
+{
+    return valid_;
+}
+
+bool bytecode::is_disabled() const
+{
+    return disabled_;
+}
+
+const bytecode::list& bytecode::instructions() const
+{
+    return instructions_;
+}
+
+script_pattern bytecode::pattern() const
+{
+    return pattern_;
+}
+
+} // namespace machine
+} // namespace libbitcoin
@@ -20,33 +20,53 @@
 
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/program.hpp>
 
 namespace libbitcoin {
 namespace machine {
 
+// Deferred signature checks are resolved whether or not evaluation fails.
+// Tracing is a distinct loop so that untraced evaluation pays nothing for it.
 code interpreter::run(program& program)
+{
+    return program.resolve(program.is_traced() ? run_program<true>(program) :
+        run_program<false>(program));
+}
+
+// private
+template <bool Traced>
+code interpreter::run_program(program& program)
 {
     code ec;
 
     if (!program.is_valid())
         return error::invalid_script;
 
-    for (const auto& op: program)
-    {
-        if (op.is_oversized())
-            return error::invalid_push_data_size;
-
-        if (op.is_disabled())
-            return error::op_disabled;
+    const auto& compiled = program.compiled();
+    const auto& instructions = compiled.instructions();
 
-        if (!program.increment_operation_count(op))
+    // Push sizes are validated by compilation, and instructions end at the
+    // first disabled operation, so neither is checked per instruction.
+    for (const auto& instruction: instructions)
+    {
+        if (!program.increment_operation_count(instruction.code))
             return error::invalid_operation_count;
 
-        if (program.if_(op))
+        if (program.if_(instruction.code))
         {
-            if ((ec = run_op(op, program)))
+            // The result of a final checksig is tested only after evaluation.
+            if (program.is_deferred() && &instruction == &instructions.back()
+                && instruction.code == opcode::checksig)
+                ec = op_check_sig(program, true);
+            else
+                ec = run_op(instruction, program);
+
+            if (Traced)
+                program.trace_operation(instruction.code);
+
+            if (ec)
                 return ec;
 
             if (program.is_stack_overflow())
@@ -54,6 +74,9 @@ code interpreter::run(program& program)
         }
     }
 
+    if (compiled.is_disabled())
+        return error::op_disabled;
+
     return program.closed() ? error::success : error::invalid_stack_scope;
 }
 
@@ -26,7 +26,7 @@
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/string.hpp>
@@ -63,8 +63,8 @@ operation operation::factory(reader& source)
 
 bool operation::from_data(const data_chunk& encoded)
 {
-    data_source istream(encoded);
-    return from_data(istream);
+    auto source = make_safe_deserializer(encoded.begin(), encoded.end());
+    return from_data(source);
 }
 
 bool operation::from_data(std::istream& stream)
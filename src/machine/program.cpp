@@ -21,9 +21,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <utility>
+#include <vector>
+#include <boost/thread.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/interpreter.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 
 namespace libbitcoin {
 namespace machine {
@@ -31,16 +36,67 @@ namespace machine {
 using namespace bc::chain;
 
 // Fixed tuning parameters, max_stack_size ensures no reallocation.
+// The condition stack is not reserved as few scripts use conditionals.
 static constexpr size_t stack_capactity = max_stack_size;
-static constexpr size_t condition_capactity = max_counted_ops;
+static constexpr size_t arena_capacity = 8;
 static const chain::transaction default_tx_;
 static const chain::script default_script_;
 
-void program::reserve_stacks()
+// Stack arena.
+//-----------------------------------------------------------------------------
+// Reserved stacks are recycled within each thread, so that programs run in
+// succession (e.g. across the inputs of a block) do not reallocate them. An
+// evaluation holds at most six stacks at once (p2sh), so the arena is small.
+
+typedef std::vector<program::stack> stack_arena;
+
+static stack_arena& get_arena()
+{
+    // Boost.thread will clean up the thread statics using this function.
+    const auto deleter = [](stack_arena* arena)
+    {
+        delete arena;
+    };
+
+    // Maintain thread static state space.
+    static boost::thread_specific_ptr<stack_arena> arena(deleter);
+
+    // This is thread safe because the instance is static.
+    if (arena.get() == nullptr)
+    {
+        arena.reset(new stack_arena);
+        arena->reserve(arena_capacity);
+    }
+
+    return *arena;
+}
+
+static program::stack acquire_stack()
+{
+    auto& arena = get_arena();
+
+    if (arena.empty())
+    {
+        program::stack stack;
+        stack.reserve(stack_capactity);
+        return stack;
+    }
+
+    auto stack = std::move(arena.back());
+    arena.pop_back();
+    return stack;
+}
+
+static void release_stack(program::stack& stack)
 {
-    primary_.reserve(stack_capactity);
-    alternate_.reserve(stack_capactity);
-    condition_.reserve(condition_capactity);
+    auto& arena = get_arena();
+
+    // A moved stack has no capacity and is not worth retaining.
+    if (stack.capacity() < stack_capactity || arena.size() >= arena_capacity)
+        return;
+
+    stack.clear();
+    arena.push_back(std::move(stack));
 }
 
 // Constructors.
@@ -51,11 +107,15 @@ program::program()
     transaction_(default_tx_),
     forks_(0),
     input_index_(0),
+    deferred_(false),
+    trace_(nullptr),
+    bytecode_(bytecode::compile(script_.bytes())),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin())
+    jump_(0),
+    primary_(acquire_stack()),
+    alternate_(acquire_stack())
 {
-    reserve_stacks();
 }
 
 program::program(const script& script)
@@ -63,52 +123,76 @@ program::program(const script& script)
     transaction_(default_tx_),
     forks_(0),
     input_index_(0),
+    deferred_(false),
+    trace_(nullptr),
+    bytecode_(bytecode::compile(script_.bytes())),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin())
+    jump_(0),
+    primary_(acquire_stack()),
+    alternate_(acquire_stack())
 {
-    reserve_stacks();
 }
 
 program::program(const script& script, const chain::transaction& transaction,
-    uint32_t input_index, uint32_t forks)
+    uint32_t input_index, uint32_t forks, bool deferred,
+    evaluation_trace* trace)
   : script_(script),
     transaction_(transaction),
     forks_(forks),
     input_index_(input_index),
+    deferred_(deferred),
+    trace_(trace),
+    bytecode_(bytecode::compile(script_.bytes())),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin())
+    jump_(0),
+    primary_(acquire_stack()),
+    alternate_(acquire_stack())
 {
-    reserve_stacks();
 }
 
-// Condition, alternate, jump and operation_count are not copied.
+// Condition, alternate, jump, operation_count and deferred signature checks are
+// not copied.
 program::program(const script& script, const program& other)
   : script_(script),
     transaction_(other.transaction_),
     forks_(other.forks_),
     input_index_(other.input_index_),
+    deferred_(other.deferred_),
+    trace_(other.trace_),
+    bytecode_(bytecode::compile(script_.bytes())),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin()),
-    primary_(other.primary_)
+    jump_(0),
+    primary_(acquire_stack()),
+    alternate_(acquire_stack())
 {
-    reserve_stacks();
+    primary_.assign(other.primary_.begin(), other.primary_.end());
 }
 
-// Condition, alternate, jump and operation_count are not moved.
+// Condition, alternate, jump, operation_count and deferred signature checks are
+// not moved.
 program::program(const script& script, program&& other, bool)
   : script_(script),
     transaction_(other.transaction_),
     forks_(other.forks_),
     input_index_(other.input_index_),
+    deferred_(other.deferred_),
+    trace_(other.trace_),
+    bytecode_(bytecode::compile(script_.bytes())),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin()),
-    primary_(std::move(other.primary_))
+    jump_(0),
+    primary_(std::move(other.primary_)),
+    alternate_(acquire_stack())
 {
-    reserve_stacks();
+}
+
+program::~program()
+{
+    release_stack(primary_);
+    release_stack(alternate_);
 }
 
 // Instructions.
@@ -124,5 +208,34 @@ code program::evaluate(const operation& op)
     return interpreter::run(op, *this);
 }
 
+// Checks are deferred in evaluation order, and synchronous evaluation would
+// have ended at the first that fails, so its failure precedes the result.
+// Only the final checksig is not a verify check, and its result is on top.
+code program::resolve(const code& result)
+{
+    auto ec = result;
+
+    for (const auto& check: signatures_)
+    {
+        if (verify_signature(check.public_key, check.sighash, check.signature))
+            continue;
+
+        if (check.verify)
+        {
+            ec = error::incorrect_signature;
+            break;
+        }
+
+        if (!ec)
+        {
+            pop();
+            push(false);
+        }
+    }
+
+    signatures_.clear();
+    return ec;
+}
+
 } // namespace machine
 } // namespace libbitcoin
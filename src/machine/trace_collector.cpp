@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/machine/trace_collector.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/bitcoin/formats/base_16.hpp>
+#include <bitcoin/bitcoin/log/source.hpp>
+#include <bitcoin/bitcoin/log/statsd_source.hpp>
+#include <bitcoin/bitcoin/machine/evaluation_trace.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+#define LOG_SCRIPT "script"
+
+using namespace std::chrono;
+
+static bool slower(const evaluation_trace& left,
+    const evaluation_trace& right)
+{
+    return left.duration > right.duration;
+}
+
+trace_collector::trace_collector(size_t worst)
+  : worst_(worst)
+{
+    clear();
+}
+
+void trace_collector::collect(const evaluation_trace& trace)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    ++inputs_;
+    duration_ += trace.duration;
+    signature_hashes_ += trace.signature_hashes;
+    stack_high_water_ = std::max(stack_high_water_, trace.stack_high_water);
+
+    if (trace.templated)
+        ++templated_;
+
+    for (size_t code = 0; code < operations_.size(); ++code)
+        operations_[code] += trace.operations[code];
+
+    // The slowest traces are retained in descending order of duration.
+    if (slowest_.size() == worst_ &&
+        (worst_ == 0 || !slower(trace, slowest_.back())))
+        return;
+
+    const auto position = std::upper_bound(slowest_.begin(), slowest_.end(),
+        trace, slower);
+    slowest_.insert(position, trace);
+
+    if (slowest_.size() > worst_)
+        slowest_.pop_back();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void trace_collector::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    inputs_ = 0;
+    templated_ = 0;
+    duration_ = asio::duration::zero();
+    operations_.fill(0);
+    stack_high_water_ = 0;
+    signature_hashes_ = 0;
+    slowest_.clear();
+    slowest_.reserve(worst_ + 1);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t trace_collector::inputs() const
+{
+    shared_lock lock(mutex_);
+    return inputs_;
+}
+
+size_t trace_collector::templated() const
+{
+    shared_lock lock(mutex_);
+    return templated_;
+}
+
+asio::duration trace_collector::duration() const
+{
+    shared_lock lock(mutex_);
+    return duration_;
+}
+
+evaluation_trace::histogram trace_collector::operations() const
+{
+    shared_lock lock(mutex_);
+    return operations_;
+}
+
+size_t trace_collector::stack_high_water() const
+{
+    shared_lock lock(mutex_);
+    return stack_high_water_;
+}
+
+size_t trace_collector::signature_hashes() const
+{
+    shared_lock lock(mutex_);
+    return signature_hashes_;
+}
+
+evaluation_trace::list trace_collector::worst() const
+{
+    shared_lock lock(mutex_);
+    return slowest_;
+}
+
+// Operations are named without regard to forks (e.g. checklocktimeverify).
+void trace_collector::report(const std::string& prefix) const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    BC_STATS_COUNTER(prefix + ".inputs", inputs_);
+    BC_STATS_COUNTER(prefix + ".templated", templated_);
+    BC_STATS_COUNTER(prefix + ".signature_hashes", signature_hashes_);
+    BC_STATS_GAUGE(prefix + ".stack_high_water", stack_high_water_);
+    BC_STATS_TIMER(prefix + ".duration", duration_cast<milliseconds>(
+        duration_));
+
+    for (size_t code = 0; code < operations_.size(); ++code)
+        if (operations_[code] != 0)
+            BC_STATS_COUNTER(prefix + ".operations." + opcode_to_string(
+                static_cast<opcode>(code), rule_fork::all_rules),
+                operations_[code]);
+
+    for (const auto& trace: slowest_)
+    {
+        BC_STATS_TIMER(prefix + ".slowest", duration_cast<milliseconds>(
+            trace.duration));
+
+        LOG_DEBUG(LOG_SCRIPT)
+            << "Slow input [" << encode_hash(trace.hash) << ":"
+            << trace.index << "] "
+            << duration_cast<microseconds>(trace.duration).count()
+            << " us, " << trace.signature_hashes << " signature hashes, "
+            << "stack high water " << trace.stack_high_water
+            << (trace.templated ? " (templated)" : "");
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace machine
+} // namespace libbitcoin
@@ -27,6 +27,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "sha256_x86.h"
 #include "zeroize.h"
 
 static uint32_t be32dec(const void* pp)
@@ -95,9 +96,27 @@ static unsigned char PAD[SHA256_BLOCK_LENGTH] =
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
+static unsigned char PAD64[SHA256_BLOCK_LENGTH] =
+{
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0
+};
+
+static unsigned char PAD32[SHA256_DIGEST_LENGTH] =
+{
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0
+};
+
 void SHA256Pad(SHA256CTX* context);
 void SHA256Transform(uint32_t state[SHA256_STATE_LENGTH],
     const uint8_t block[SHA256_BLOCK_LENGTH]);
+void SHA256TransformBlocks(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count);
+void SHA256TransformPortable(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t block[SHA256_BLOCK_LENGTH]);
 
 void SHA256_(const uint8_t* input, size_t length,
     uint8_t digest[SHA256_DIGEST_LENGTH])
@@ -149,16 +168,63 @@ void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length)
     input += 64 - r;
     length -= 64 - r;
 
-    while (length >= 64)
+    if (length >= 64)
     {
-        SHA256Transform(context->state, input);
-        input += 64;
-        length -= 64;
+        SHA256TransformBlocks(context->state, input, length / 64);
+        input += length & ~(size_t)0x3f;
+        length &= 0x3f;
     }
 
     memcpy(context->buf, input, length);
 }
 
+void SHA256D64(uint8_t* output, const uint8_t* input, size_t count)
+{
+    SHA256CTX context;
+    uint8_t buffer[SHA256_BLOCK_LENGTH];
+
+#ifdef SHA256_X86
+    const int features = SHA256X86Features();
+
+    /* A single sha-ni lane outpaces the avx2 lanes, so defer to transform. */
+    if ((features & SHA256_X86_SHANI) == 0)
+    {
+        if ((features & SHA256_X86_AVX2) != 0)
+        {
+            for (; count >= 8; count -= 8, input += 512, output += 256)
+            {
+                    SHA256X86Double64Avx2(output, input);
+            }
+        }
+
+        if ((features & SHA256_X86_SSE41) != 0)
+        {
+            for (; count >= 4; count -= 4, input += 256, output += 128)
+            {
+                    SHA256X86Double64Sse41(output, input);
+            }
+        }
+    }
+#endif
+
+    /* The output is written only after its input is read (overlap safe). */
+    for (; count > 0; --count, input += 64, output += 32)
+    {
+        SHA256Init(&context);
+        SHA256Transform(context.state, input);
+        SHA256Transform(context.state, PAD64);
+        be32enc_vect(buffer, context.state, SHA256_DIGEST_LENGTH);
+        memcpy(&buffer[SHA256_DIGEST_LENGTH], PAD32, SHA256_DIGEST_LENGTH);
+
+        SHA256Init(&context);
+        SHA256Transform(context.state, buffer);
+        be32enc_vect(output, context.state, SHA256_DIGEST_LENGTH);
+    }
+
+    zeroize((void*)&context, sizeof context);
+    zeroize((void*)buffer, sizeof buffer);
+}
+
 void SHA256Final(SHA256CTX* context, uint8_t digest[SHA256_DIGEST_LENGTH])
 {
     SHA256Pad(context);
@@ -184,6 +250,29 @@ void SHA256Pad(SHA256CTX* context)
 
 void SHA256Transform(uint32_t state[SHA256_STATE_LENGTH],
     const uint8_t block[SHA256_BLOCK_LENGTH])
+{
+    SHA256TransformBlocks(state, block, 1);
+}
+
+void SHA256TransformBlocks(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count)
+{
+#ifdef SHA256_X86
+    if ((SHA256X86Features() & SHA256_X86_SHANI) != 0)
+    {
+        SHA256X86TransformShani(state, blocks, count);
+        return;
+    }
+#endif
+
+    for (; count > 0; --count, blocks += SHA256_BLOCK_LENGTH)
+    {
+        SHA256TransformPortable(state, blocks);
+    }
+}
+
+void SHA256TransformPortable(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t block[SHA256_BLOCK_LENGTH])
 {
     int i;
     uint32_t W[64];
@@ -53,6 +53,10 @@ void SHA256Init(SHA256CTX* context);
 void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length);
 void SHA256Final(SHA256CTX* context, uint8_t digest[SHA256_DIGEST_LENGTH]);
 
+/* Double sha256 of each of count consecutive 64 byte messages, writing count
+ * consecutive 32 byte digests. The output may overlap the input. */
+void SHA256D64(uint8_t* output, const uint8_t* input, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
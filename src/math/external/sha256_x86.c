@@ -0,0 +1,334 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_x86.h"
+
+#ifdef SHA256_X86
+
+#include <stdint.h>
+#include <stddef.h>
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define SSE41 __attribute__((target("sse4.1")))
+#define AVX2 __attribute__((target("avx2")))
+#define SHANI __attribute__((target("sha,sse4.1")))
+
+static const uint32_t K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t IV[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static uint32_t be32dec(const uint8_t* p)
+{
+    return ((uint32_t)(p[3]) + ((uint32_t)(p[2]) << 8) +
+        ((uint32_t)(p[1]) << 16) + ((uint32_t)(p[0]) << 24));
+}
+
+static void be32enc(uint8_t* p, uint32_t x)
+{
+    p[3] = x & 0xff;
+    p[2] = (x >> 8) & 0xff;
+    p[1] = (x >> 16) & 0xff;
+    p[0] = (x >> 24) & 0xff;
+}
+
+/* Feature detection. */
+
+static uint64_t xgetbv(void)
+{
+    uint32_t low, high;
+    __asm__ ("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((uint64_t)high << 32) | low;
+}
+
+static int detect(void)
+{
+    int features = 0;
+    unsigned int eax, ebx, ecx, edx;
+    int ssse3, sse41, osxsave, avx;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0)
+        return features;
+
+    ssse3 = (ecx >> 9) & 1;
+    sse41 = (ecx >> 19) & 1;
+    osxsave = (ecx >> 27) & 1;
+    avx = (ecx >> 28) & 1;
+
+    if (sse41)
+        features |= SHA256_X86_SSE41;
+
+    if (__get_cpuid_max(0, NULL) < 7)
+        return features;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    /* The os must preserve the xmm and ymm registers for avx2 use. */
+    if (osxsave && avx && ((xgetbv() & 6) == 6) && ((ebx >> 5) & 1))
+        features |= SHA256_X86_AVX2;
+
+    if (ssse3 && sse41 && ((ebx >> 29) & 1))
+        features |= SHA256_X86_SHANI;
+
+    return features;
+}
+
+int SHA256X86Features(void)
+{
+    /* Detection is idempotent, so a race only repeats the detection. */
+    static int features = -1;
+    int value = __atomic_load_n(&features, __ATOMIC_RELAXED);
+
+    if (value < 0)
+    {
+        value = detect();
+        __atomic_store_n(&features, value, __ATOMIC_RELAXED);
+    }
+
+    return value;
+}
+
+/* Sha extensions, one block at a time. */
+
+static inline SHANI void quad(__m128i* abef, __m128i* cdgh, __m128i message,
+    int group)
+{
+    const __m128i k = _mm_loadu_si128((const __m128i*)&K[4 * group]);
+    const __m128i words = _mm_add_epi32(message, k);
+    *cdgh = _mm_sha256rnds2_epu32(*cdgh, *abef, words);
+    *abef = _mm_sha256rnds2_epu32(*abef, *cdgh,
+        _mm_shuffle_epi32(words, 0x0e));
+}
+
+SHANI void SHA256X86TransformShani(uint32_t state[8], const uint8_t* blocks,
+    size_t count)
+{
+    int group;
+    __m128i abef, cdgh, abef_save, cdgh_save, temp, next;
+    __m128i m0, m1, m2, m3;
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+        0x0405060700010203ULL);
+
+    /* Reorder the state words into the lanes expected by the rounds. */
+    temp = _mm_loadu_si128((const __m128i*)&state[0]);
+    cdgh = _mm_loadu_si128((const __m128i*)&state[4]);
+    temp = _mm_shuffle_epi32(temp, 0xb1);
+    cdgh = _mm_shuffle_epi32(cdgh, 0x1b);
+    abef = _mm_alignr_epi8(temp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, temp, 0xf0);
+
+    for (; count > 0; --count, blocks += 64)
+    {
+        abef_save = abef;
+        cdgh_save = cdgh;
+
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks +  0)),
+            mask);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 16)),
+            mask);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 32)),
+            mask);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 48)),
+            mask);
+
+        quad(&abef, &cdgh, m0, 0);
+        quad(&abef, &cdgh, m1, 1);
+        quad(&abef, &cdgh, m2, 2);
+        quad(&abef, &cdgh, m3, 3);
+
+        for (group = 4; group < 16; ++group)
+        {
+            next = _mm_add_epi32(_mm_sha256msg1_epu32(m0, m1),
+                _mm_alignr_epi8(m3, m2, 4));
+            next = _mm_sha256msg2_epu32(next, m3);
+            quad(&abef, &cdgh, next, group);
+            m0 = m1;
+            m1 = m2;
+            m2 = m3;
+            m3 = next;
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    temp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    abef = _mm_blend_epi16(temp, cdgh, 0xf0);
+    cdgh = _mm_alignr_epi8(cdgh, temp, 8);
+    _mm_storeu_si128((__m128i*)&state[0], abef);
+    _mm_storeu_si128((__m128i*)&state[4], cdgh);
+}
+
+/* Multiple messages in parallel lanes, each lane an independent message. */
+
+#define LANE_FUNCTIONS(TARGET, V, N, ADD, XOR, AND, OR, SRL, SLL, SET1) \
+static inline TARGET V add##N(V a, V b) { return ADD(a, b); } \
+static inline TARGET V xor##N(V a, V b) { return XOR(a, b); } \
+static inline TARGET V rotr##N(V x, int n) \
+{ \
+    return OR(SRL(x, n), SLL(x, 32 - n)); \
+} \
+static inline TARGET V ch##N(V x, V y, V z) \
+{ \
+    return XOR(AND(x, XOR(y, z)), z); \
+} \
+static inline TARGET V maj##N(V x, V y, V z) \
+{ \
+    return OR(AND(x, OR(y, z)), AND(y, z)); \
+} \
+static inline TARGET V big_sigma0##N(V x) \
+{ \
+    return xor##N(xor##N(rotr##N(x, 2), rotr##N(x, 13)), rotr##N(x, 22)); \
+} \
+static inline TARGET V big_sigma1##N(V x) \
+{ \
+    return xor##N(xor##N(rotr##N(x, 6), rotr##N(x, 11)), rotr##N(x, 25)); \
+} \
+static inline TARGET V sigma0##N(V x) \
+{ \
+    return xor##N(xor##N(rotr##N(x, 7), rotr##N(x, 18)), SRL(x, 3)); \
+} \
+static inline TARGET V sigma1##N(V x) \
+{ \
+    return xor##N(xor##N(rotr##N(x, 17), rotr##N(x, 19)), SRL(x, 10)); \
+} \
+static TARGET void transform##N(V state[8], V w[64]) \
+{ \
+    int i; \
+    V a = state[0], b = state[1], c = state[2], d = state[3]; \
+    V e = state[4], f = state[5], g = state[6], h = state[7]; \
+    V t1, t2; \
+    for (i = 16; i < 64; ++i) \
+        w[i] = add##N(add##N(sigma1##N(w[i - 2]), w[i - 7]), \
+            add##N(sigma0##N(w[i - 15]), w[i - 16])); \
+    for (i = 0; i < 64; ++i) \
+    { \
+        t1 = add##N(add##N(add##N(h, big_sigma1##N(e)), ch##N(e, f, g)), \
+            add##N(SET1((int)K[i]), w[i])); \
+        t2 = add##N(big_sigma0##N(a), maj##N(a, b, c)); \
+        h = g; g = f; f = e; e = add##N(d, t1); \
+        d = c; c = b; b = a; a = add##N(t1, t2); \
+    } \
+    state[0] = add##N(state[0], a); state[1] = add##N(state[1], b); \
+    state[2] = add##N(state[2], c); state[3] = add##N(state[3], d); \
+    state[4] = add##N(state[4], e); state[5] = add##N(state[5], f); \
+    state[6] = add##N(state[6], g); state[7] = add##N(state[7], h); \
+} \
+static TARGET void double64##N(V w[64], V out[8]) \
+{ \
+    int i; \
+    V state[8]; \
+    for (i = 0; i < 8; ++i) \
+        state[i] = SET1((int)IV[i]); \
+    transform##N(state, w); \
+    /* Padding block of a 64 byte message. */ \
+    w[0] = SET1((int)0x80000000); \
+    for (i = 1; i < 15; ++i) \
+        w[i] = SET1(0); \
+    w[15] = SET1(512); \
+    transform##N(state, w); \
+    /* Single block of the 32 byte first digest. */ \
+    for (i = 0; i < 8; ++i) \
+    { \
+        w[i] = state[i]; \
+        out[i] = SET1((int)IV[i]); \
+    } \
+    w[8] = SET1((int)0x80000000); \
+    for (i = 9; i < 15; ++i) \
+        w[i] = SET1(0); \
+    w[15] = SET1(256); \
+    transform##N(out, w); \
+}
+
+LANE_FUNCTIONS(SSE41, __m128i, 4, _mm_add_epi32, _mm_xor_si128,
+    _mm_and_si128, _mm_or_si128, _mm_srli_epi32, _mm_slli_epi32,
+    _mm_set1_epi32)
+
+LANE_FUNCTIONS(AVX2, __m256i, 8, _mm256_add_epi32, _mm256_xor_si256,
+    _mm256_and_si256, _mm256_or_si256, _mm256_srli_epi32, _mm256_slli_epi32,
+    _mm256_set1_epi32)
+
+#define WORD(lane, word) (int)be32dec(in + 64 * (lane) + 4 * (word))
+
+SSE41 void SHA256X86Double64Sse41(uint8_t* out, const uint8_t* in)
+{
+    int i, lane;
+    __m128i w[64], digest[8];
+    uint32_t words[4];
+
+    for (i = 0; i < 16; ++i)
+        w[i] = _mm_set_epi32(WORD(3, i), WORD(2, i), WORD(1, i), WORD(0, i));
+
+    double644(w, digest);
+
+    for (i = 0; i < 8; ++i)
+    {
+        _mm_storeu_si128((__m128i*)words, digest[i]);
+
+        for (lane = 0; lane < 4; ++lane)
+            be32enc(out + 32 * lane + 4 * i, words[lane]);
+    }
+}
+
+AVX2 void SHA256X86Double64Avx2(uint8_t* out, const uint8_t* in)
+{
+    int i, lane;
+    __m256i w[64], digest[8];
+    uint32_t words[8];
+
+    for (i = 0; i < 16; ++i)
+        w[i] = _mm256_set_epi32(WORD(7, i), WORD(6, i), WORD(5, i),
+            WORD(4, i), WORD(3, i), WORD(2, i), WORD(1, i), WORD(0, i));
+
+    double648(w, digest);
+
+    for (i = 0; i < 8; ++i)
+    {
+        _mm256_storeu_si256((__m256i*)words, digest[i]);
+
+        for (lane = 0; lane < 8; ++lane)
+            be32enc(out + 32 * lane + 4 * i, words[lane]);
+    }
+}
+
+#undef WORD
+
+#endif
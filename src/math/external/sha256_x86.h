@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SHA256_X86_H
+#define LIBBITCOIN_SHA256_X86_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Accelerated transforms are compiled with per-function target attributes, so
+ * no build flags are required and selection is deferred to run time. */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SHA256_X86
+#endif
+
+#ifdef SHA256_X86
+
+#define SHA256_X86_SSE41 1
+#define SHA256_X86_AVX2 2
+#define SHA256_X86_SHANI 4
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Cached bit set of the SHA256_X86_* features supported by cpu and os. */
+int SHA256X86Features(void);
+
+/* Transform consecutive blocks using the sha extensions. */
+void SHA256X86TransformShani(uint32_t state[8], const uint8_t* blocks,
+    size_t count);
+
+/* Double hash 4 (sse4.1) or 8 (avx2) consecutive 64 byte messages.
+ * All input is read before output is written, so buffers may overlap. */
+void SHA256X86Double64Sse41(uint8_t* out, const uint8_t* in);
+void SHA256X86Double64Avx2(uint8_t* out, const uint8_t* in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
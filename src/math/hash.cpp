@@ -40,6 +40,65 @@ hash_digest bitcoin_hash(data_slice data)
     return sha256_hash(sha256_hash(data));
 }
 
+void bitcoin_hash_64(uint8_t* out, const uint8_t* in, size_t count)
+{
+    SHA256D64(out, in, count);
+}
+
+static_assert(sizeof(hash_digest) == hash_size,
+    "merkle levels must be contiguous hashes");
+
+// Reduce a merkle tree level (of more than one hash) to its parent level.
+static void merkle_reduce(hash_list& level)
+{
+    if (level.size() % 2 != 0)
+        level.push_back(level.back());
+
+    // Each pair of adjacent hashes is a contiguous 64 byte message.
+    const auto data = level.front().data();
+    const auto count = level.size() / 2;
+    bitcoin_hash_64(data, data, count);
+    level.resize(count);
+}
+
+hash_digest merkle_root(const hash_list& hashes)
+{
+    if (hashes.empty())
+        return null_hash;
+
+    // Reserve for the odd hash duplication, avoiding any reallocation.
+    hash_list level;
+    level.reserve(hashes.size() + 1);
+    level.assign(hashes.begin(), hashes.end());
+
+    while (level.size() > 1)
+        merkle_reduce(level);
+
+    return level.front();
+}
+
+hash_list merkle_branch(const hash_list& hashes, size_t index)
+{
+    hash_list branch;
+
+    if (index >= hashes.size())
+        return branch;
+
+    hash_list level;
+    level.reserve(hashes.size() + 1);
+    level.assign(hashes.begin(), hashes.end());
+
+    for (; level.size() > 1; index /= 2)
+    {
+        // The odd last hash is paired with itself.
+        const auto sibling = index ^ 1;
+        branch.push_back(level[sibling < level.size() ? sibling : index]);
+        merkle_reduce(level);
+    }
+
+    return branch;
+}
+
 short_hash bitcoin_short_hash(data_slice data)
 {
     return ripemd160_hash(sha256_hash(data));
@@ -132,6 +191,44 @@ long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
     return hash;
 }
 
+// sha256_context
+//-----------------------------------------------------------------------------
+
+static_assert(sizeof(SHA256CTX) == sizeof(sha256_context),
+    "sha256_context must mirror the sha256 implementation context");
+
+sha256_context::sha256_context()
+{
+    SHA256CTX context;
+    SHA256Init(&context);
+    std::copy_n(context.state, SHA256_STATE_LENGTH, state_);
+    std::copy_n(context.count, SHA256_COUNT_LENGTH, count_);
+    std::copy_n(context.buf, SHA256_BLOCK_LENGTH, buffer_);
+}
+
+void sha256_context::write(data_slice data)
+{
+    SHA256CTX context;
+    std::copy_n(state_, SHA256_STATE_LENGTH, context.state);
+    std::copy_n(count_, SHA256_COUNT_LENGTH, context.count);
+    std::copy_n(buffer_, SHA256_BLOCK_LENGTH, context.buf);
+    SHA256Update(&context, data.data(), data.size());
+    std::copy_n(context.state, SHA256_STATE_LENGTH, state_);
+    std::copy_n(context.count, SHA256_COUNT_LENGTH, count_);
+    std::copy_n(context.buf, SHA256_BLOCK_LENGTH, buffer_);
+}
+
+hash_digest sha256_context::finalize() const
+{
+    hash_digest hash;
+    SHA256CTX context;
+    std::copy_n(state_, SHA256_STATE_LENGTH, context.state);
+    std::copy_n(count_, SHA256_COUNT_LENGTH, context.count);
+    std::copy_n(buffer_, SHA256_BLOCK_LENGTH, context.buf);
+    SHA256Final(&context, hash.data());
+    return hash;
+}
+
 static void handle_script_result(int result)
 {
     if (result == 0)
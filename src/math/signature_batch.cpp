@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/signature_batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <secp256k1.h>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include "secp256k1_initializer.hpp"
+
+namespace libbitcoin {
+
+// Items are claimed by threads in fixed size groups to limit contention.
+static constexpr size_t group_size = 16;
+
+size_t signature_batch::push(data_slice point, const hash_digest& hash,
+    const ec_signature& signature)
+{
+    item value;
+    value.hash = hash;
+    value.signature = signature;
+    value.valid = false;
+
+    // An oversized point cannot parse, so is retained as empty (invalid).
+    const auto size = point.size() <= ec_uncompressed_size ? point.size() : 0;
+    std::copy_n(point.begin(), size, value.point.begin());
+    value.point_size = static_cast<uint8_t>(size);
+
+    items_.push_back(value);
+    return items_.size() - 1;
+}
+
+size_t signature_batch::size() const
+{
+    return items_.size();
+}
+
+bool signature_batch::empty() const
+{
+    return items_.empty();
+}
+
+void signature_batch::reserve(size_t size)
+{
+    items_.reserve(size);
+}
+
+void signature_batch::clear()
+{
+    items_.clear();
+}
+
+bool signature_batch::is_valid(size_t index) const
+{
+    return index < items_.size() && items_[index].valid;
+}
+
+bool signature_batch::verify()
+{
+    return verify(0, items_.size());
+}
+
+bool signature_batch::verify(dispatcher& dispatch)
+{
+    std::atomic<bool> valid(true);
+    const auto groups = (items_.size() + group_size - 1) / group_size;
+
+    // Results are written only to items of the claimed group.
+    const auto verify_group = [this, &valid](size_t group)
+    {
+        const auto first = group * group_size;
+        const auto last = std::min(first + group_size, items_.size());
+
+        if (!verify(first, last))
+            valid = false;
+
+        // Continue past failures, as each item requires a result.
+        return true;
+    };
+
+    dispatch.parallel_for(groups, verify_group);
+    return valid;
+}
+
+// The pubkey is parsed once for a run of identical points (a common case).
+bool signature_batch::verify(size_t first, size_t last)
+{
+    auto valid = true;
+    auto parsed = false;
+    secp256k1_pubkey pubkey;
+    const item* previous = nullptr;
+    const auto context = verification.context();
+
+    for (auto index = first; index < last; ++index)
+    {
+        auto& value = items_[index];
+        const auto begin = value.point.begin();
+        const auto end = begin + value.point_size;
+
+        if (previous == nullptr || previous->point_size != value.point_size ||
+            !std::equal(begin, end, previous->point.begin()))
+        {
+            parsed = secp256k1_ec_pubkey_parse(context, &pubkey,
+                value.point.data(), value.point_size) == 1;
+        }
+
+        previous = &value;
+
+        if (!parsed)
+        {
+            value.valid = valid = false;
+            continue;
+        }
+
+        // Copy to avoid exposing external types.
+        secp256k1_ecdsa_signature signature;
+        std::copy_n(value.signature.begin(), ec_signature_size,
+            std::begin(signature.data));
+
+        // secp256k1_ecdsa_verify rejects non-normalized (low-s) signatures,
+        // but bitcoin does not have such a limitation, so we always normalize.
+        secp256k1_ecdsa_signature normal;
+        secp256k1_ecdsa_signature_normalize(context, &normal, &signature);
+
+        value.valid = secp256k1_ecdsa_verify(context, &normal,
+            value.hash.data(), &pubkey) == 1;
+        valid = valid && value.valid;
+    }
+
+    return valid;
+}
+
+} // namespace libbitcoin
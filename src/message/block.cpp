@@ -92,9 +92,10 @@ block::block(const chain::header& header,
 {
 }
 
+// Inbound blocks are always identified, so hash from the wire bytes.
 bool block::from_data(uint32_t, const data_chunk& data)
 {
-    return chain::block::from_data(data);
+    return chain::block::from_data(data, true);
 }
 
 bool block::from_data(uint32_t, std::istream& stream)
@@ -18,14 +18,19 @@
  */
 #include <bitcoin/bitcoin/message/merkle_block.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
 #include <bitcoin/bitcoin/chain/block.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/math/limits.hpp>
 #include <bitcoin/bitcoin/message/messages.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -36,6 +41,72 @@ const std::string merkle_block::command = "merkleblock";
 const uint32_t merkle_block::version_minimum = version::level::bip37;
 const uint32_t merkle_block::version_maximum = version::level::maximum;
 
+// Partial merkle tree (bip37).
+//-----------------------------------------------------------------------------
+
+typedef std::vector<hash_list> merkle_levels;
+
+// All levels of the merkle tree from the leaves to the root, without the
+// duplicated odd last hash, so the width of each level is its size.
+static merkle_levels to_levels(hash_list&& leaves)
+{
+    merkle_levels levels;
+    auto level = std::move(leaves);
+    level.reserve(level.size() + 1);
+
+    while (level.size() > 1)
+    {
+        levels.push_back(level);
+
+        if (level.size() % 2 != 0)
+            level.push_back(level.back());
+
+        const auto data = level.front().data();
+        const auto count = level.size() / 2;
+        bitcoin_hash_64(data, data, count);
+        level.resize(count);
+    }
+
+    levels.push_back(std::move(level));
+    return levels;
+}
+
+// Depth first traversal, descending only into subtrees containing a match.
+static void traverse(const merkle_levels& levels,
+    const std::vector<bool>& matches, size_t height, size_t position,
+    hash_list& hashes, std::vector<bool>& bits)
+{
+    const auto first = std::min(position << height, matches.size());
+    const auto last = std::min((position + 1) << height, matches.size());
+    const auto parent = std::find(matches.begin() + first,
+        matches.begin() + last, true) != matches.begin() + last;
+
+    bits.push_back(parent);
+
+    if (height == 0 || !parent)
+    {
+        hashes.push_back(levels[height][position]);
+        return;
+    }
+
+    const auto left = position * 2;
+    traverse(levels, matches, height - 1, left, hashes, bits);
+
+    if (left + 1 < levels[height - 1].size())
+        traverse(levels, matches, height - 1, left + 1, hashes, bits);
+}
+
+static data_chunk to_flags(const std::vector<bool>& bits)
+{
+    data_chunk flags((bits.size() + 7) / 8, 0x00);
+
+    for (size_t bit = 0; bit < bits.size(); ++bit)
+        if (bits[bit])
+            flags[bit / 8] |= (1 << (bit % 8));
+
+    return flags;
+}
+
 merkle_block merkle_block::factory(uint32_t version,
     const data_chunk& data)
 {
@@ -89,6 +160,21 @@ merkle_block::merkle_block(const chain::block& block)
 {
 }
 
+merkle_block::merkle_block(const chain::block& block,
+    const std::vector<bool>& matches)
+  : header_(block.header()),
+    total_transactions_(safe_unsigned<uint32_t>(block.transactions().size())),
+    hashes_(), flags_()
+{
+    if (total_transactions_ == 0)
+        return;
+
+    std::vector<bool> bits;
+    const auto levels = to_levels(block.to_hashes());
+    traverse(levels, matches, levels.size() - 1, 0, hashes_, bits);
+    flags_ = to_flags(bits);
+}
+
 merkle_block::merkle_block(const merkle_block& other)
   : merkle_block(other.header_, other.total_transactions_, other.hashes_,
       other.flags_)
@@ -118,8 +204,8 @@ void merkle_block::reset()
 
 bool merkle_block::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(version, source);
 }
 
 bool merkle_block::from_data(uint32_t version, std::istream& stream)
@@ -21,7 +21,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -99,8 +99,8 @@ void network_address::reset()
 bool network_address::from_data(uint32_t version,
     const data_chunk& data, bool with_timestamp)
 {
-    data_source istream(data);
-    return from_data(version, istream, with_timestamp);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(version, source, with_timestamp);
 }
 
 bool network_address::from_data(uint32_t version,
@@ -95,9 +95,10 @@ transaction::transaction(uint32_t version, uint32_t locktime,
 {
 }
 
+// Inbound transactions are always identified, so hash from the wire bytes.
 bool transaction::from_data(uint32_t, const data_chunk& data)
 {
-    return chain::transaction::from_data(data, true);
+    return chain::transaction::from_data(data, true, true);
 }
 
 bool transaction::from_data(uint32_t, std::istream& stream)
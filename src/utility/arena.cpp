@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/utility/arena.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+const size_t arena::default_block_size = 64 * 1024;
+
+arena::arena(size_t block_size)
+  : block_size_(std::max(block_size, size_t(1))),
+    reserved_(0),
+    position_(nullptr),
+    end_(nullptr)
+{
+}
+
+void* arena::allocate(size_t size, size_t alignment)
+{
+    BITCOIN_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    const auto align = [alignment](char* pointer)
+    {
+        const auto value = reinterpret_cast<uintptr_t>(pointer);
+        const auto aligned = (value + alignment - 1) & ~(alignment - 1);
+        return reinterpret_cast<char*>(aligned);
+    };
+
+    auto start = align(position_);
+
+    if (position_ != nullptr && start <= end_ &&
+        size <= static_cast<size_t>(end_ - start))
+    {
+        position_ = start + size;
+        return start;
+    }
+
+    // Reserve room to align within a new region.
+    const auto needed = size + alignment - 1;
+    if (needed < size)
+        throw std::bad_alloc();
+
+    // Oversized requests get a dedicated region, preserving the current one.
+    if (needed > block_size_)
+    {
+        regions_.emplace_back(new char[needed]);
+        reserved_ += needed;
+        return align(regions_.back().get());
+    }
+
+    regions_.emplace_back(new char[block_size_]);
+    reserved_ += block_size_;
+    end_ = regions_.back().get() + block_size_;
+    start = align(regions_.back().get());
+    position_ = start + size;
+    return start;
+}
+
+void arena::release()
+{
+    regions_.clear();
+    regions_.shrink_to_fit();
+    reserved_ = 0;
+    position_ = nullptr;
+    end_ = nullptr;
+}
+
+size_t arena::reserved() const
+{
+    return reserved_;
+}
+
+} // namespace libbitcoin
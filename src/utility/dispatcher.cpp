@@ -18,18 +18,101 @@
  */
 #include <bitcoin/bitcoin/utility/dispatcher.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <bitcoin/bitcoin/utility/executor.hpp>
 #include <bitcoin/bitcoin/utility/threadpool.hpp>
 #include <bitcoin/bitcoin/utility/work.hpp>
 
 namespace libbitcoin {
 
 dispatcher::dispatcher(threadpool& pool, const std::string& name)
-  : heap_(std::make_shared<work>(pool, name)), pool_(pool)
+  : heap_(std::make_shared<work>(pool, name)), pool_(pool),
+    executor_(nullptr)
 {
 }
 
+dispatcher::dispatcher(threadpool& pool, executor& concurrent,
+    const std::string& name)
+  : heap_(std::make_shared<work>(pool, name)), pool_(pool),
+    executor_(&concurrent)
+{
+}
+
+// Shared by the calling thread and the posted helpers, which may start after
+// the loop is complete and so must not touch the job once claims run out.
+struct loop_state
+{
+    typedef std::shared_ptr<loop_state> ptr;
+
+    loop_state(size_t count, dispatcher::loop_handler&& job)
+      : count(count), job(std::move(job)), next(0), stopped(false), active(0)
+    {
+    }
+
+    const size_t count;
+    const dispatcher::loop_handler job;
+    std::atomic<size_t> next;
+    std::atomic<bool> stopped;
+
+    // These are protected by mutex.
+    size_t active;
+    std::mutex mutex;
+    std::condition_variable idle;
+};
+
+static void run_loop(loop_state::ptr state)
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        ++state->active;
+    }
+
+    while (!state->stopped)
+    {
+        const auto index = state->next++;
+
+        if (index >= state->count)
+            break;
+
+        if (!state->job(index))
+            state->stopped = true;
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    if (--state->active == 0)
+        state->idle.notify_all();
+}
+
+void dispatcher::parallel_for(size_t count, loop_handler job)
+{
+    if (count == 0)
+        return;
+
+    const auto state = std::make_shared<loop_state>(count, std::move(job));
+
+    // The calling thread accounts for one of the workers.
+    const auto helpers = std::min(size(), count - 1);
+
+    for (size_t helper = 0; helper < helpers; ++helper)
+        concurrent(run_loop, state);
+
+    run_loop(state);
+
+    // Helpers that have yet to start cannot claim an index, wait on the rest.
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle.wait(lock, [&state]()
+    {
+        return state->active == 0;
+    });
+}
+
 ////size_t dispatcher::ordered_backlog()
 ////{
 ////    return heap_->ordered_backlog();
@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/utility/executor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+// Queues are created before threads, and neither changes until destruction.
+executor::executor(size_t number_threads, thread_priority priority)
+  : pending_(0), sleeping_(0), next_(0), stopped_(false)
+{
+    for (size_t index = 0; index < number_threads; ++index)
+        queues_.emplace_back(new queue);
+
+    for (size_t index = 0; index < number_threads; ++index)
+    {
+        threads_.emplace_back(&executor::run, this, index, priority);
+        ids_.push_back(threads_.back().get_id());
+    }
+}
+
+executor::~executor()
+{
+    shutdown();
+    join();
+}
+
+size_t executor::size() const
+{
+    return queues_.size();
+}
+
+// Ids are only read by pool threads from within jobs, which are queued after
+// construction, so the queue mutex orders the read after the write.
+size_t executor::target()
+{
+    const auto this_id = boost::this_thread::get_id();
+    const auto it = std::find(ids_.begin(), ids_.end(), this_id);
+
+    if (it != ids_.end())
+        return static_cast<size_t>(std::distance(ids_.begin(), it));
+
+    return next_++ % queues_.size();
+}
+
+void executor::concurrent(job&& handler)
+{
+    if (stopped_ || queues_.empty())
+        return;
+
+    auto& target_queue = *queues_[target()];
+
+    // Counted before queuing so that shutdown cannot strand a queued job.
+    // Sequentially consistent with the sleeper count, see run.
+    ++pending_;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        std::lock_guard<std::mutex> lock(target_queue.mutex);
+        target_queue.jobs.push_back(std::move(handler));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (sleeping_ == 0)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_.notify_one();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Take the newest job from the thread's own queue.
+bool executor::take(size_t index, job& out)
+{
+    auto& own = *queues_[index];
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(own.mutex);
+
+    if (own.jobs.empty())
+        return false;
+
+    out = std::move(own.jobs.back());
+    own.jobs.pop_back();
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Take the oldest job from the next non-empty queue of another thread.
+bool executor::steal(size_t index, job& out)
+{
+    const auto count = queues_.size();
+
+    for (size_t offset = 1; offset < count; ++offset)
+    {
+        auto& other = *queues_[(index + offset) % count];
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::lock_guard<std::mutex> lock(other.mutex);
+
+        if (other.jobs.empty())
+            continue;
+
+        out = std::move(other.jobs.front());
+        other.jobs.pop_front();
+        return true;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return false;
+}
+
+// A poster increments pending and then reads the sleeper count, while a
+// sleeper increments the sleeper count and then reads pending (under the
+// idle mutex), so at least one observes the other and no wakeup is lost.
+void executor::run(size_t index, thread_priority priority)
+{
+    set_priority(priority);
+    job handler;
+
+    while (true)
+    {
+        if (take(index, handler) || steal(index, handler))
+        {
+            --pending_;
+            handler();
+            handler = nullptr;
+            continue;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        ++sleeping_;
+
+        idle_.wait(lock, [this]()
+        {
+            return pending_ != 0 || stopped_;
+        });
+
+        --sleeping_;
+
+        if (stopped_ && pending_ == 0)
+            return;
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+void executor::shutdown()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    stopped_ = true;
+    idle_.notify_all();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void executor::join()
+{
+    DEBUG_ONLY(const auto this_id = boost::this_thread::get_id();)
+
+    for (auto& thread: threads_)
+    {
+        BITCOIN_ASSERT(this_id != thread.get_id());
+
+        if (thread.joinable())
+            thread.join();
+    }
+}
+
+} // namespace libbitcoin
@@ -46,6 +46,57 @@ static bool all_valid(const chain::transaction::list& transactions)
     return valid;
 }
 
+// Test helper.
+static chain::chain_state::ptr connect_state()
+{
+    chain::chain_state::data values;
+    values.height = 1;
+    values.bits.self = 0x1d00ffff;
+    values.bits.ordered = { 0x1d00ffff };
+    values.version.self = 1;
+    values.version.ordered = { 1 };
+    values.timestamp.self = 0;
+    values.timestamp.retarget = 0;
+    values.timestamp.ordered = { 0 };
+    return std::make_shared<chain::chain_state>(std::move(values),
+        chain::chain_state::checkpoints{}, machine::rule_fork::bip16_rule);
+}
+
+// Test helper.
+static chain::transaction connect_transaction(uint32_t version,
+    const std::vector<bool>& valid)
+{
+    static const chain::script pass{ { { machine::opcode::push_positive_1 } } };
+    static const chain::script fail{ { { machine::opcode::push_size_0 } } };
+
+    chain::input::list inputs;
+
+    for (size_t index = 0; index < valid.size(); ++index)
+    {
+        chain::output_point prevout{ null_hash, static_cast<uint32_t>(index) };
+        prevout.validation.cache = { 0, valid[index] ? pass : fail };
+        inputs.emplace_back(std::move(prevout), chain::script{}, 0);
+    }
+
+    return { version, 0, std::move(inputs), {} };
+}
+
+// Test helper.
+static chain::block connect_block(
+    const std::vector<std::vector<bool>>& transactions)
+{
+    chain::transaction::list txs
+    {
+        { 1, 0, { { { null_hash, chain::point::null_index }, {}, 0 } }, {} }
+    };
+
+    for (size_t tx = 0; tx < transactions.size(); ++tx)
+        txs.push_back(connect_transaction(static_cast<uint32_t>(tx + 2),
+            transactions[tx]));
+
+    return { {}, std::move(txs) };
+}
+
 BOOST_AUTO_TEST_SUITE(chain_block_tests)
 
 BOOST_AUTO_TEST_CASE(block__proof1__genesis_mainnet__expected)
@@ -411,6 +462,40 @@ BOOST_AUTO_TEST_CASE(block__generate_merkle_root__block_with_multiple_transactio
     BOOST_REQUIRE(header.merkle() == block100k.generate_merkle_root());
 }
 
+BOOST_AUTO_TEST_CASE(block__from_data__hash__matches_computed_hashes)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    auto coinbase = genesis.transactions().front();
+    auto other = coinbase;
+    other.set_locktime(42);
+    const chain::block original(genesis.header(), { coinbase, other });
+    const auto raw = original.to_data();
+
+    chain::block expected;
+    BOOST_REQUIRE(expected.from_data(raw));
+
+    chain::block instance;
+    BOOST_REQUIRE(instance.from_data(raw, true));
+    BOOST_REQUIRE(instance == expected);
+    BOOST_REQUIRE(instance.hash() == expected.hash());
+
+    const auto& transactions = instance.transactions();
+    BOOST_REQUIRE_EQUAL(transactions.size(), expected.transactions().size());
+
+    for (size_t index = 0; index < transactions.size(); ++index)
+        BOOST_REQUIRE(transactions[index].hash() ==
+            expected.transactions()[index].hash());
+}
+
+BOOST_AUTO_TEST_CASE(block__factory__hash_insufficient_bytes__failure)
+{
+    auto raw = chain::block::genesis_mainnet().to_data();
+    raw.pop_back();
+
+    const auto instance = chain::block::factory(raw, true);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
 BOOST_AUTO_TEST_CASE(block__header_accessor__always__returns_initialized_value)
 {
     const chain::header header(10u,
@@ -719,4 +804,96 @@ BOOST_AUTO_TEST_CASE(block__is_forward_reference__forward_reference__true)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(block_connect_tests)
+
+BOOST_AUTO_TEST_CASE(block__connect_transactions__dispatch_all_valid__success)
+{
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    const auto state = connect_state();
+    const auto value = connect_block({ { true, true }, { true }, { true, true, true } });
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state), error::success);
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state, dispatch), error::success);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block__connect_transactions__dispatch_invalid__matches_sequential)
+{
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    const auto state = connect_state();
+    const auto value = connect_block({ { true, true }, { true, true, false }, { false, true } });
+    const auto expected = value.connect_transactions(*state);
+    BOOST_REQUIRE_EQUAL(expected, error::stack_false);
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state, dispatch), expected);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block__connect_transactions__dispatch_multiple_failures__lowest_failure)
+{
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    const auto state = connect_state();
+    const auto value = connect_block({ { true, true, true, true }, { true, false, true }, { false, false } });
+
+    for (size_t iteration = 0; iteration < 100; ++iteration)
+    {
+        chain::input_point failure;
+        BOOST_REQUIRE_EQUAL(value.connect_transactions(*state, dispatch, failure), error::stack_false);
+        BOOST_REQUIRE(failure.hash() == value.transactions()[2].hash());
+        BOOST_REQUIRE_EQUAL(failure.index(), 1u);
+    }
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block__connect_transactions__empty_threadpool__lowest_failure)
+{
+    threadpool pool(0);
+    dispatcher dispatch(pool, "test");
+    const auto state = connect_state();
+    const auto value = connect_block({ { true, false }, { false } });
+    chain::input_point failure;
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state, dispatch, failure), error::stack_false);
+    BOOST_REQUIRE(failure.hash() == value.transactions()[1].hash());
+    BOOST_REQUIRE_EQUAL(failure.index(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(block__connect_transactions__script_cache__stores_then_hits)
+{
+    const auto state = connect_state();
+    const auto value = connect_block({ { true, true }, { true } });
+    value.validation.scripts = std::make_shared<chain::script_cache>(10);
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state), error::success);
+    BOOST_REQUIRE_EQUAL(value.validation.scripts->size(), 3u);
+    BOOST_REQUIRE_EQUAL(value.validation.scripts->hits(), 0u);
+
+    threadpool pool(2);
+    dispatcher dispatch(pool, "test");
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state, dispatch), error::success);
+    BOOST_REQUIRE_EQUAL(value.validation.scripts->hits(), 3u);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block__connect_transactions__script_cache_pool_verified__skipped)
+{
+    const auto state = connect_state();
+    const auto value = connect_block({ { true, false } });
+    const auto& tx = value.transactions()[1];
+    const auto scripts = std::make_shared<chain::script_cache>(10);
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state), error::stack_false);
+
+    // A cached verification is not repeated (so this failure is not found).
+    scripts->store(tx, 1, state->enabled_forks());
+    value.validation.scripts = scripts;
+    BOOST_REQUIRE_EQUAL(value.connect_transactions(*state), error::success);
+    BOOST_REQUIRE_EQUAL(scripts->hits(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+static const chain_state::checkpoints no_checkpoints{};
+
+static const uint32_t mainnet_forks = rule_fork::retarget |
+    rule_fork::bip16_rule | rule_fork::bip34_activations;
+
+static const uint32_t testnet_forks = rule_fork::easy_blocks |
+    rule_fork::retarget | rule_fork::bip16_rule |
+    rule_fork::bip34_activations;
+
+// Versions rise through each bip34-based version, with lapses.
+static header::list make_headers(size_t count)
+{
+    header::list headers;
+    hash_digest previous = null_hash;
+
+    for (size_t height = 0; height < count; ++height)
+    {
+        const uint32_t version = height % 7 == 0 ? 1 :
+            static_cast<uint32_t>(1 + height / 400);
+        const uint32_t timestamp = static_cast<uint32_t>(
+            1000000 + height * 600 - (height % 5) * 900);
+        const uint32_t bits = height % 3 == 0 ? 0x1c7fffff : 0x1d00ffff;
+
+        headers.emplace_back(version, previous, null_hash, timestamp, bits, 0);
+        previous = headers.back().hash();
+    }
+
+    return headers;
+}
+
+// Populate state data from the headers as a store query would.
+static chain_state::data make_data(const header::list& headers, size_t height,
+    uint32_t forks)
+{
+    const auto map = chain_state::get_map(height, no_checkpoints, forks);
+    const auto& self = headers[height];
+
+    chain_state::data data;
+    data.height = height;
+    data.hash = self.hash();
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bits.self = self.bits();
+    data.version.self = self.version();
+    data.timestamp.self = self.timestamp();
+    data.timestamp.retarget = headers[map.timestamp_retarget].timestamp();
+
+    for (auto at = map.bits.high + 1 - map.bits.count; at <= map.bits.high; ++at)
+        data.bits.ordered.push_back(headers[at].bits());
+
+    for (auto at = map.version.high + 1 - map.version.count; at <= map.version.high; ++at)
+        data.version.ordered.push_back(headers[at].version());
+
+    for (auto at = map.timestamp.high + 1 - map.timestamp.count; at <= map.timestamp.high; ++at)
+        data.timestamp.ordered.push_back(headers[at].timestamp());
+
+    return data;
+}
+
+static void require_equal(const chain_state& left, const chain_state& right)
+{
+    BOOST_REQUIRE_EQUAL(left.height(), right.height());
+    BOOST_REQUIRE_EQUAL(left.enabled_forks(), right.enabled_forks());
+    BOOST_REQUIRE_EQUAL(left.minimum_block_version(), right.minimum_block_version());
+    BOOST_REQUIRE_EQUAL(left.median_time_past(), right.median_time_past());
+    BOOST_REQUIRE_EQUAL(left.work_required(), right.work_required());
+}
+
+// Promotion through a header must produce the state populated at its height.
+static void require_promotion_equivalent(uint32_t forks)
+{
+    const auto headers = make_headers(2100);
+    auto parent = std::make_shared<chain_state>(make_data(headers, 1, forks),
+        no_checkpoints, forks);
+
+    for (size_t height = 2; height < headers.size(); ++height)
+    {
+        const auto child = std::make_shared<chain_state>(*parent,
+            headers[height]);
+        const chain_state expected(make_data(headers, height, forks),
+            no_checkpoints, forks);
+
+        require_equal(*child, expected);
+        parent = child;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(chain_state_tests)
+
+BOOST_AUTO_TEST_CASE(chain_state__header_promotion__mainnet__equivalent)
+{
+    require_promotion_equivalent(mainnet_forks);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__header_promotion__testnet__equivalent)
+{
+    require_promotion_equivalent(testnet_forks);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__header_promotion__fork__branches_independent)
+{
+    const auto headers = make_headers(20);
+    const auto alternate = make_headers(30);
+    const chain_state parent(make_data(headers, 10, mainnet_forks),
+        no_checkpoints, mainnet_forks);
+
+    // Both children extend the parent's histories, the second must copy.
+    const chain_state first(parent, headers[11]);
+    const chain_state second(parent, alternate[25]);
+    const chain_state expected(make_data(headers, 11, mainnet_forks),
+        no_checkpoints, mainnet_forks);
+
+    require_equal(first, expected);
+    require_equal(chain_state(first, headers[12]),
+        chain_state(make_data(headers, 12, mainnet_forks), no_checkpoints,
+            mainnet_forks));
+    BOOST_REQUIRE_EQUAL(second.median_time_past(), first.median_time_past());
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__median_time_past__unordered__modulo_two_median)
+{
+    chain_state::data data;
+    data.height = 4;
+    data.hash = null_hash;
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bits.self = 0x1d00ffff;
+    data.bits.ordered = { 0x1d00ffff };
+    data.version.self = 1;
+    data.version.ordered = { 1, 1, 1, 1 };
+    data.timestamp.self = 0;
+    data.timestamp.retarget = 0;
+    data.timestamp.ordered = { 40, 10, 30, 20 };
+
+    const chain_state instance(std::move(data), no_checkpoints,
+        rule_fork::no_rules);
+    BOOST_REQUIRE_EQUAL(instance.median_time_past(), 30u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
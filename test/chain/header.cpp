@@ -174,6 +174,19 @@ BOOST_AUTO_TEST_CASE(header__factory_3__valid_input__success)
     BOOST_REQUIRE(expected == result);
 }
 
+BOOST_AUTO_TEST_CASE(header__factory_1__hash__matches_computed_hash)
+{
+    const auto expected = chain::block::genesis_mainnet().header();
+    const auto data = expected.to_data();
+
+    const auto result = chain::header::factory(data, true, true);
+
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_REQUIRE(expected == result);
+    BOOST_REQUIRE(result.hash() == bitcoin_hash(data));
+    BOOST_REQUIRE(result.hash() == hash_literal("000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f"));
+}
+
 BOOST_AUTO_TEST_CASE(header__version_accessor__always__returns_initialized_value)
 {
     const uint32_t value = 11234u;
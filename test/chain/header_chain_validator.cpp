@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::config;
+using namespace bc::machine;
+
+// Regtest bypasses retargeting, so work required is the preceding bits.
+static const uint32_t regtest_forks = rule_fork::bip16_rule;
+static const uint32_t regtest_bits = 0x207fffff;
+static const uint32_t genesis_timestamp = 1000000;
+
+static header mine(const hash_digest& previous, uint32_t timestamp,
+    uint32_t bits=regtest_bits)
+{
+    header value(4, previous, null_hash, timestamp, bits, 0);
+
+    while (!value.is_valid_proof_of_work(false))
+        value.set_nonce(value.nonce() + 1);
+
+    return value;
+}
+
+// Headers at heights 0 and 1, from which the parent state is populated.
+static header::list make_base()
+{
+    header::list headers;
+    headers.push_back(mine(null_hash, genesis_timestamp));
+    headers.push_back(mine(headers.back().hash(), genesis_timestamp + 600));
+    return headers;
+}
+
+static chain_state::ptr make_parent(const header::list& base,
+    const chain_state::checkpoints& checkpoints)
+{
+    chain_state::data data;
+    data.height = 1;
+    data.hash = base[1].hash();
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bits.self = base[1].bits();
+    data.bits.ordered = { base[0].bits() };
+    data.version.self = base[1].version();
+    data.version.ordered = { base[0].version() };
+    data.timestamp.self = base[1].timestamp();
+    data.timestamp.retarget = base[0].timestamp();
+    data.timestamp.ordered = { base[0].timestamp() };
+    return std::make_shared<chain_state>(std::move(data), checkpoints,
+        regtest_forks);
+}
+
+// Extend the base with valid headers, starting at height 2.
+static header::list make_headers(const header::list& base, size_t count)
+{
+    header::list headers;
+    auto previous = base.back().hash();
+    auto timestamp = base.back().timestamp();
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        headers.push_back(mine(previous, timestamp += 600));
+        previous = headers.back().hash();
+    }
+
+    return headers;
+}
+
+// Relink (and remine) all headers following the index.
+static void relink(header::list& headers, size_t index)
+{
+    for (auto next = index + 1; next < headers.size(); ++next)
+        headers[next] = mine(headers[next - 1].hash(),
+            headers[next].timestamp());
+}
+
+// Remine the header at the index and relink all following headers.
+static void remine(header::list& headers, size_t index, uint32_t bits,
+    uint32_t timestamp)
+{
+    headers[index] = mine(headers[index].previous_block_hash(), timestamp,
+        bits);
+    relink(headers, index);
+}
+
+// Validate with and without dispatch, requiring the same code and tip.
+static code validate(const header::list& headers,
+    const chain_state::checkpoints& checkpoints, size_t expected_height)
+{
+    const auto base = make_base();
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    header_chain_validator sequential(make_parent(base, checkpoints),
+        checkpoints);
+    header_chain_validator concurrent(make_parent(base, checkpoints),
+        checkpoints);
+
+    const auto expected = sequential.validate(headers);
+    const auto result = concurrent.validate(headers, dispatch);
+    pool.shutdown();
+    pool.join();
+
+    BOOST_REQUIRE_EQUAL(result, expected);
+    BOOST_REQUIRE_EQUAL(sequential.tip()->height(), expected_height);
+    BOOST_REQUIRE_EQUAL(concurrent.tip()->height(), expected_height);
+    BOOST_REQUIRE_EQUAL(concurrent.validated(), expected_height - 1);
+    return result;
+}
+
+BOOST_AUTO_TEST_SUITE(header_chain_validator_tests)
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__empty__success)
+{
+    static const chain_state::checkpoints checkpoints{};
+    BOOST_REQUIRE_EQUAL(validate({}, checkpoints, 1), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__valid__success_tip_advanced)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    const auto headers = make_headers(base, 50);
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 51), error::success);
+
+    header_chain_validator instance(make_parent(base, checkpoints),
+        checkpoints);
+    BOOST_REQUIRE_EQUAL(instance.validate(headers), error::success);
+    BOOST_REQUIRE(instance.tip()->hash() == headers.back().hash());
+    BOOST_REQUIRE(headers.back().validation.state == instance.tip());
+    BOOST_REQUIRE_EQUAL(headers.back().validation.height, 51u);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__batches__equals_single_batch)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    const auto headers = make_headers(base, 30);
+    const header::list first(headers.begin(), headers.begin() + 10);
+    const header::list second(headers.begin() + 10, headers.end());
+
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    header_chain_validator instance(make_parent(base, checkpoints),
+        checkpoints);
+    BOOST_REQUIRE_EQUAL(instance.validate(first, dispatch), error::success);
+    BOOST_REQUIRE_EQUAL(instance.validate(second, dispatch), error::success);
+    pool.shutdown();
+    pool.join();
+
+    BOOST_REQUIRE_EQUAL(instance.tip()->height(), 31u);
+    BOOST_REQUIRE_EQUAL(instance.validated(), 30u);
+    BOOST_REQUIRE(instance.tip()->hash() == headers.back().hash());
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__unlinked__invalid_previous_block)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    auto headers = make_headers(base, 20);
+    headers[7] = mine(null_hash, headers[7].timestamp());
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 8), error::invalid_previous_block);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__first_unlinked__invalid_previous_block)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    const auto headers = make_headers({ base.front() }, 5);
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 1), error::invalid_previous_block);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__insufficient_work__invalid_proof_of_work)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    auto headers = make_headers(base, 20);
+
+    // Find a nonce for which the hash exceeds the claimed target.
+    while (headers[12].is_valid_proof_of_work(false))
+        headers[12].set_nonce(headers[12].nonce() + 1);
+
+    relink(headers, 12);
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 13), error::invalid_proof_of_work);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__contextual_failure_before_check_failure__contextual_code)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    auto headers = make_headers(base, 20);
+
+    // Bits differ from work required, and a later header is not linked.
+    remine(headers, 4, 0x1f7fffff, headers[4].timestamp());
+    headers[15] = mine(null_hash, headers[15].timestamp());
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 5), error::incorrect_proof_of_work);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__early_timestamp__timestamp_too_early)
+{
+    static const chain_state::checkpoints checkpoints{};
+    const auto base = make_base();
+    auto headers = make_headers(base, 20);
+    remine(headers, 9, regtest_bits, headers[2].timestamp());
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 10), error::timestamp_too_early);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__checkpoint_conflict__checkpoints_failed)
+{
+    const auto base = make_base();
+    const auto headers = make_headers(base, 20);
+
+    // The header at index 5 is at height 7.
+    const chain_state::checkpoints checkpoints{ { null_hash, 7 } };
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 6), error::checkpoints_failed);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__checkpoint_match__success)
+{
+    const auto base = make_base();
+    const auto headers = make_headers(base, 20);
+    const chain_state::checkpoints checkpoints{ { headers[5].hash(), 7 } };
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 21), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(header_chain_validator__validate__checkpoint_conflict_insufficient_bits__incorrect_proof_of_work)
+{
+    const auto base = make_base();
+    auto headers = make_headers(base, 20);
+    remine(headers, 5, 0x1f7fffff, headers[5].timestamp());
+
+    // Work required is accepted before the checkpoint.
+    const chain_state::checkpoints checkpoints{ { null_hash, 7 } };
+    BOOST_REQUIRE_EQUAL(validate(headers, checkpoints, 6), error::incorrect_proof_of_work);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
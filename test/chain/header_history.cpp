@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static std::vector<uint32_t> to_vector(const header_history& history)
+{
+    return { history.begin(), history.end() };
+}
+
+BOOST_AUTO_TEST_SUITE(header_history_tests)
+
+BOOST_AUTO_TEST_CASE(header_history__constructor__default__empty)
+{
+    const header_history instance;
+    BOOST_REQUIRE(instance.empty());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.begin() == instance.end());
+}
+
+BOOST_AUTO_TEST_CASE(header_history__constructor__list__expected)
+{
+    const header_history instance(header_history::list{ 1, 2, 3 });
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.front(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.back(), 3u);
+    BOOST_REQUIRE_EQUAL(instance[1], 2u);
+    BOOST_REQUIRE_EQUAL(*instance.rbegin(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(header_history__push_back__copy__original_unchanged)
+{
+    const header_history original(header_history::list{ 1, 2, 3 });
+    auto copy = original;
+    copy.push_back(4);
+    copy.pop_front();
+    BOOST_REQUIRE(to_vector(original) == (std::vector<uint32_t>{ 1, 2, 3 }));
+    BOOST_REQUIRE(to_vector(copy) == (std::vector<uint32_t>{ 2, 3, 4 }));
+}
+
+BOOST_AUTO_TEST_CASE(header_history__push_back__two_copies__distinct_branches)
+{
+    const header_history parent(header_history::list{ 1, 2 });
+    auto first = parent;
+    auto second = parent;
+    first.push_back(3);
+    second.push_back(42);
+    BOOST_REQUIRE(to_vector(parent) == (std::vector<uint32_t>{ 1, 2 }));
+    BOOST_REQUIRE(to_vector(first) == (std::vector<uint32_t>{ 1, 2, 3 }));
+    BOOST_REQUIRE(to_vector(second) == (std::vector<uint32_t>{ 1, 2, 42 }));
+}
+
+BOOST_AUTO_TEST_CASE(header_history__push_back__beyond_capacity__window_retained)
+{
+    header_history instance;
+    std::vector<header_history> states;
+
+    // Each state is a copy of its parent extended by one, as for chain state.
+    for (uint32_t value = 0; value < 10000; ++value)
+    {
+        instance.push_back(value);
+
+        if (instance.size() > 11)
+            instance.pop_front();
+
+        states.push_back(instance);
+    }
+
+    for (uint32_t value = 0; value < 10000; ++value)
+    {
+        const auto& state = states[value];
+        BOOST_REQUIRE_EQUAL(state.back(), value);
+        BOOST_REQUIRE_EQUAL(state.front(), value < 11 ? 0 : value - 10);
+        BOOST_REQUIRE_EQUAL(state.size(), std::min(value + 1u, 11u));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_history__push_back__concurrent_copies__distinct_branches)
+{
+    const header_history parent(header_history::list{ 1, 2, 3 });
+    std::vector<header_history> branches(8, parent);
+    std::vector<std::thread> threads;
+
+    for (size_t branch = 0; branch < branches.size(); ++branch)
+    {
+        threads.emplace_back([&branches, branch]()
+        {
+            for (uint32_t value = 0; value < 1000; ++value)
+                branches[branch].push_back(static_cast<uint32_t>(branch));
+        });
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    BOOST_REQUIRE(to_vector(parent) == (std::vector<uint32_t>{ 1, 2, 3 }));
+
+    for (size_t branch = 0; branch < branches.size(); ++branch)
+    {
+        const auto values = to_vector(branches[branch]);
+        BOOST_REQUIRE_EQUAL(values.size(), 1003u);
+        BOOST_REQUIRE_EQUAL(values[2], 3u);
+        BOOST_REQUIRE(std::all_of(values.begin() + 3, values.end(),
+            [branch](uint32_t value) { return value == branch; }));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -390,4 +390,13 @@ BOOST_AUTO_TEST_CASE(input__operator_boolean_not_equals__differs__returns_true)
     BOOST_REQUIRE(alpha != beta);
 }
 
+BOOST_AUTO_TEST_CASE(input__sizeof__within_budget)
+{
+    // Point, script, a shared addresses cache and the sequence.
+    static const auto budget = sizeof(output_point) + sizeof(script) +
+        sizeof(std::shared_ptr<void>) + sizeof(size_t);
+
+    BOOST_REQUIRE_LE(sizeof(input), budget);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
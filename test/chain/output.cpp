@@ -228,4 +228,13 @@ BOOST_AUTO_TEST_CASE(output__operator_boolean_not_equals__differs__returns_true)
     BOOST_REQUIRE(alpha != beta);
 }
 
+BOOST_AUTO_TEST_CASE(output__sizeof__within_budget)
+{
+    // Value, script, a shared addresses cache and the validation height.
+    static const auto budget = sizeof(uint64_t) + sizeof(chain::script) +
+        sizeof(std::shared_ptr<void>) + sizeof(size_t);
+
+    BOOST_REQUIRE_LE(sizeof(chain::output), budget);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
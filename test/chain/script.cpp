@@ -18,7 +18,11 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include <memory>
+#include <numeric>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include "script.hpp"
 
@@ -548,6 +552,390 @@ BOOST_AUTO_TEST_CASE(script__context_free__invalid)
     }
 }
 
+// Template fast path tests.
+//------------------------------------------------------------------------------
+
+static const uint32_t template_forks[]
+{
+    rule_fork::no_rules,
+    rule_fork::bip16_rule,
+    rule_fork::bip66_rule,
+    rule_fork::all_rules
+};
+
+// Require that a matched template produces the result of evaluation.
+static bool template_equivalent(const transaction& tx, const script& input,
+    const script& prevout, uint32_t forks)
+{
+    code out;
+    if (!script::verify_template(out, tx, 0, forks, input, prevout))
+        return false;
+
+    BOOST_REQUIRE_EQUAL(out.value(),
+        script::evaluate(tx, 0, forks, input, prevout).value());
+    return true;
+}
+
+static ec_secret template_secret(uint8_t seed)
+{
+    ec_secret secret{ {} };
+    secret.back() = seed;
+    return secret;
+}
+
+static data_chunk template_point(uint8_t seed)
+{
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, template_secret(seed)));
+    return to_chunk(point);
+}
+
+static transaction template_tx()
+{
+    return transaction
+    {
+        1, 0,
+        input::list{ input{ output_point{ null_hash, 0 }, script{}, 0xffffffff } },
+        output::list{ output{ 1, script{} } }
+    };
+}
+
+static endorsement template_endorse(uint8_t seed, const script& script_code,
+    const transaction& tx)
+{
+    endorsement out;
+    BOOST_REQUIRE(script::create_endorsement(out, template_secret(seed),
+        script_code, tx, 0, sighash_algorithm::all));
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__data_driven__equivalent)
+{
+    const std::vector<const script_test_list*> lists
+    {
+        &valid_bip16_scripts, &invalidated_bip16_scripts,
+        &valid_bip65_scripts, &invalid_bip65_scripts,
+        &invalidated_bip65_scripts, &valid_multisig_scripts,
+        &invalid_multisig_scripts, &valid_context_free_scripts,
+        &invalid_context_free_scripts
+    };
+
+    size_t matched = 0;
+
+    for (const auto list: lists)
+    {
+        for (const auto& test: *list)
+        {
+            const auto tx = new_tx(test);
+            BOOST_REQUIRE(!tx.inputs().empty());
+            const auto& input = tx.inputs().front();
+            const auto& prevout = input.previous_output().validation.cache;
+
+            for (const auto forks: template_forks)
+                if (template_equivalent(tx, input.script(), prevout.script(),
+                    forks))
+                    ++matched;
+        }
+    }
+
+    BOOST_REQUIRE_GT(matched, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__pay_key_hash__equivalent)
+{
+    const auto tx = template_tx();
+    const auto point = template_point(1);
+    const script prevout(script::to_pay_key_hash_pattern(
+        bitcoin_short_hash(point)));
+    const auto endorsement = template_endorse(1, prevout, tx);
+
+    // Valid.
+    const script valid(operation::list{ operation(endorsement), operation(point) });
+
+    // Signed by another key.
+    const script wrong_signer(operation::list{ operation(template_endorse(2, prevout, tx)), operation(point) });
+
+    // Key does not match the hash.
+    const script wrong_key(operation::list{ operation(endorsement), operation(template_point(2)) });
+
+    // Signature hash type changed after signing.
+    auto retyped = endorsement;
+    retyped.back() = sighash_algorithm::single;
+    const script wrong_type(operation::list{ operation(retyped), operation(point) });
+
+    // Not an endorsement.
+    const script invalid(operation::list{ operation(data_chunk{ 0x42 }), operation(point) });
+
+    for (const auto forks: template_forks)
+    {
+        BOOST_REQUIRE(template_equivalent(tx, valid, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, wrong_signer, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, wrong_key, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, wrong_type, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, invalid, prevout, forks));
+        BOOST_REQUIRE_EQUAL(script::verify(tx, 0, forks, valid, prevout).value(), error::success);
+        BOOST_REQUIRE(script::verify(tx, 0, forks, wrong_signer, prevout) != error::success);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__pay_script_hash_multisig__equivalent)
+{
+    const auto tx = template_tx();
+    const script redeem(script::to_pay_multisig_pattern(2,
+        data_stack{ template_point(1), template_point(2), template_point(3) }));
+    const auto redeem_data = redeem.to_data(false);
+    const script prevout(script::to_pay_script_hash_pattern(
+        bitcoin_short_hash(redeem_data)));
+
+    const auto first = template_endorse(1, redeem, tx);
+    const auto second = template_endorse(2, redeem, tx);
+    const auto third = template_endorse(3, redeem, tx);
+    const operation dummy(opcode::push_size_0);
+
+    // Valid, in key order.
+    const script valid(operation::list{ dummy, operation(first), operation(third), operation(redeem_data) });
+
+    // Out of key order.
+    const script reversed(operation::list{ dummy, operation(third), operation(first), operation(redeem_data) });
+
+    // One key twice.
+    const script repeated(operation::list{ dummy, operation(second), operation(second), operation(redeem_data) });
+
+    // Redeem script does not match the hash.
+    const script wrong_redeem(operation::list{ dummy, operation(first), operation(second), operation(first) });
+
+    for (const auto forks: template_forks)
+    {
+        BOOST_REQUIRE(template_equivalent(tx, valid, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, reversed, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, repeated, prevout, forks));
+        BOOST_REQUIRE(template_equivalent(tx, wrong_redeem, prevout, forks));
+        BOOST_REQUIRE_EQUAL(script::verify(tx, 0, forks, valid, prevout).value(), error::success);
+    }
+
+    BOOST_REQUIRE(script::verify(tx, 0, rule_fork::bip16_rule, reversed, prevout) != error::success);
+    BOOST_REQUIRE_EQUAL(script::verify(tx, 0, rule_fork::no_rules, reversed, prevout).value(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__endorsement_in_redeem__deferred)
+{
+    const auto tx = template_tx();
+    const auto first = template_endorse(1, script{}, tx);
+
+    // An endorsement pushed by the redeem script is subject to find_and_delete.
+    const script redeem(operation::list
+    {
+        operation(opcode::push_positive_1), operation(first),
+        operation(template_point(1)), operation(opcode::push_positive_2),
+        operation(opcode::checkmultisig)
+    });
+
+    const auto redeem_data = redeem.to_data(false);
+    const script prevout(script::to_pay_script_hash_pattern(
+        bitcoin_short_hash(redeem_data)));
+    const script input(operation::list{ operation(opcode::push_size_0), operation(first), operation(redeem_data) });
+
+    code out;
+    BOOST_REQUIRE(!script::verify_template(out, tx, 0, rule_fork::all_rules, input, prevout));
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__non_standard__not_matched)
+{
+    const auto tx = template_tx();
+    const script prevout(operation::list{ operation(opcode::push_positive_1) });
+    const script input(operation::list{ operation(opcode::push_positive_1) });
+
+    code out;
+    BOOST_REQUIRE(!script::verify_template(out, tx, 0, rule_fork::all_rules, input, prevout));
+}
+
+// Deferred signature tests.
+//------------------------------------------------------------------------------
+
+// Require that deferred signature checks produce the result of evaluation.
+static code deferred_equivalent(const transaction& tx, const script& input,
+    const script& prevout, uint32_t forks)
+{
+    const auto expected = script::evaluate(tx, 0, forks, input, prevout);
+    const auto result = script::evaluate(tx, 0, forks, input, prevout, true);
+    BOOST_REQUIRE_EQUAL(result.value(), expected.value());
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__deferred_data_driven__equivalent)
+{
+    const std::vector<const script_test_list*> lists
+    {
+        &valid_bip16_scripts, &invalidated_bip16_scripts,
+        &valid_bip65_scripts, &invalid_bip65_scripts,
+        &invalidated_bip65_scripts, &valid_multisig_scripts,
+        &invalid_multisig_scripts, &valid_context_free_scripts,
+        &invalid_context_free_scripts
+    };
+
+    for (const auto list: lists)
+    {
+        for (const auto& test: *list)
+        {
+            const auto tx = new_tx(test);
+            BOOST_REQUIRE(!tx.inputs().empty());
+            const auto& input = tx.inputs().front();
+            const auto& prevout = input.previous_output().validation.cache;
+
+            for (const auto forks: template_forks)
+                deferred_equivalent(tx, input.script(), prevout.script(),
+                    forks);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__deferred_final_checksig__equivalent)
+{
+    const auto tx = template_tx();
+    const auto point = template_point(1);
+    const script prevout(script::to_pay_key_hash_pattern(
+        bitcoin_short_hash(point)));
+
+    const script valid(operation::list{ operation(template_endorse(1, prevout, tx)), operation(point) });
+    const script wrong_signer(operation::list{ operation(template_endorse(2, prevout, tx)), operation(point) });
+
+    BOOST_REQUIRE_EQUAL(deferred_equivalent(tx, valid, prevout, rule_fork::all_rules).value(), error::success);
+    BOOST_REQUIRE_EQUAL(deferred_equivalent(tx, wrong_signer, prevout, rule_fork::all_rules).value(), error::stack_false);
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__deferred_checksigverify_then_failure__incorrect_signature)
+{
+    const auto tx = template_tx();
+    const auto point = template_point(1);
+    script prevout;
+    BOOST_REQUIRE(prevout.from_string("checksigverify return"));
+
+    const script wrong_signer(operation::list{ operation(template_endorse(2, prevout, tx)), operation(point) });
+    BOOST_REQUIRE_EQUAL(deferred_equivalent(tx, wrong_signer, prevout, rule_fork::all_rules).value(), error::incorrect_signature);
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__deferred_checksigverify_then_success__success)
+{
+    const auto tx = template_tx();
+    const auto point = template_point(1);
+    script prevout;
+    BOOST_REQUIRE(prevout.from_string("checksigverify 1"));
+
+    const script valid(operation::list{ operation(template_endorse(1, prevout, tx)), operation(point) });
+    BOOST_REQUIRE_EQUAL(deferred_equivalent(tx, valid, prevout, rule_fork::all_rules).value(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__deferred_checksig_not_final__equivalent)
+{
+    const auto tx = template_tx();
+    const auto point = template_point(1);
+    script prevout;
+    BOOST_REQUIRE(prevout.from_string("checksig not"));
+
+    const script wrong_signer(operation::list{ operation(template_endorse(2, prevout, tx)), operation(point) });
+    BOOST_REQUIRE_EQUAL(deferred_equivalent(tx, wrong_signer, prevout, rule_fork::all_rules).value(), error::success);
+}
+
+// Trace tests.
+//------------------------------------------------------------------------------
+
+static size_t total_operations(const evaluation_trace& trace)
+{
+    return std::accumulate(trace.operations.begin(), trace.operations.end(),
+        size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__traced_data_driven__equivalent)
+{
+    const std::vector<const script_test_list*> lists
+    {
+        &valid_bip16_scripts, &invalidated_bip16_scripts,
+        &valid_multisig_scripts, &invalid_multisig_scripts,
+        &valid_context_free_scripts, &invalid_context_free_scripts
+    };
+
+    for (const auto list: lists)
+    {
+        for (const auto& test: *list)
+        {
+            const auto tx = new_tx(test);
+            BOOST_REQUIRE(!tx.inputs().empty());
+            const auto& input = tx.inputs().front();
+            const auto& prevout = input.previous_output().validation.cache;
+
+            for (const auto forks: template_forks)
+            {
+                evaluation_trace trace;
+                const auto expected = script::evaluate(tx, 0, forks, input.script(), prevout.script());
+                const auto result = script::evaluate(tx, 0, forks, input.script(), prevout.script(), false, &trace);
+                BOOST_REQUIRE_EQUAL(result.value(), expected.value());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__traced_pay_key_hash__expected_profile)
+{
+    const auto tx = template_tx();
+    const auto point = template_point(1);
+    const script prevout(script::to_pay_key_hash_pattern(bitcoin_short_hash(point)));
+    const script input(operation::list{ operation(template_endorse(1, prevout, tx)), operation(point) });
+
+    evaluation_trace trace;
+    BOOST_REQUIRE_EQUAL(script::evaluate(tx, 0, rule_fork::all_rules, input, prevout, false, &trace).value(), error::success);
+    BOOST_REQUIRE_EQUAL(total_operations(trace), 7u);
+    BOOST_REQUIRE_EQUAL(trace.operations[static_cast<uint8_t>(opcode::dup)], 1u);
+    BOOST_REQUIRE_EQUAL(trace.operations[static_cast<uint8_t>(opcode::hash160)], 1u);
+    BOOST_REQUIRE_EQUAL(trace.operations[static_cast<uint8_t>(opcode::equalverify)], 1u);
+    BOOST_REQUIRE_EQUAL(trace.operations[static_cast<uint8_t>(opcode::checksig)], 1u);
+    BOOST_REQUIRE_EQUAL(trace.stack_high_water, 4u);
+    BOOST_REQUIRE_EQUAL(trace.signature_hashes, 1u);
+    BOOST_REQUIRE(!trace.templated);
+}
+
+BOOST_AUTO_TEST_CASE(script__evaluate__traced_unexecuted_branch__not_counted)
+{
+    script prevout;
+    BOOST_REQUIRE(prevout.from_string("0 if checksig endif 1"));
+
+    evaluation_trace trace;
+    BOOST_REQUIRE_EQUAL(script::evaluate(template_tx(), 0, rule_fork::all_rules, script{}, prevout, false, &trace).value(), error::success);
+    BOOST_REQUIRE_EQUAL(total_operations(trace), 4u);
+    BOOST_REQUIRE_EQUAL(trace.operations[static_cast<uint8_t>(opcode::checksig)], 0u);
+    BOOST_REQUIRE_EQUAL(trace.signature_hashes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify__traced_pay_key_hash__templated)
+{
+    const auto point = template_point(1);
+    const script prevout(script::to_pay_key_hash_pattern(bitcoin_short_hash(point)));
+    const script input(operation::list{ operation(template_endorse(1, prevout, template_tx())), operation(point) });
+
+    // The signature hash does not commit to input scripts.
+    output_point outpoint{ null_hash, 0 };
+    outpoint.validation.cache.set_script(prevout);
+    const transaction tx
+    {
+        1, 0,
+        input::list{ chain::input{ std::move(outpoint), input, 0xffffffff } },
+        output::list{ output{ 1, script{} } }
+    };
+
+    evaluation_trace trace;
+    BOOST_REQUIRE_EQUAL(script::verify(tx, 0, rule_fork::all_rules, trace).value(), error::success);
+    BOOST_REQUIRE(trace.templated);
+    BOOST_REQUIRE(trace.hash == tx.hash());
+    BOOST_REQUIRE_EQUAL(trace.index, 0u);
+    BOOST_REQUIRE_EQUAL(trace.signature_hashes, 1u);
+    BOOST_REQUIRE_EQUAL(total_operations(trace), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify__traced_invalid_index__operation_failed)
+{
+    evaluation_trace trace;
+    BOOST_REQUIRE_EQUAL(script::verify(template_tx(), 1, rule_fork::all_rules, trace).value(), error::operation_failed);
+}
+
 // Checksig tests.
 //------------------------------------------------------------------------------
 
@@ -748,4 +1136,204 @@ BOOST_AUTO_TEST_CASE(script__native__block_438513_tx__valid)
     BOOST_REQUIRE_EQUAL(result.value(), error::success);
 }
 
+BOOST_AUTO_TEST_CASE(script__sizeof__within_budget)
+{
+    // Bytes, shared operations and analysis caches and the validity flag.
+    static const auto budget = sizeof(data_chunk) +
+        2 * sizeof(std::shared_ptr<void>) + sizeof(size_t);
+
+    BOOST_REQUIRE_LE(sizeof(script), budget);
+}
+
+BOOST_AUTO_TEST_CASE(script__copy__decoded__shares_operations)
+{
+    const auto instance = script::factory(to_chunk(base16_literal(
+        "76a91418c0bd8d1818f1bf99cb1df2269c645318ef7b7388ac")), false);
+    const auto& operations = instance.operations();
+    BOOST_REQUIRE_EQUAL(operations.size(), 5u);
+
+    const script copy(instance);
+    BOOST_REQUIRE(&copy.operations() == &operations);
+}
+
+BOOST_AUTO_TEST_CASE(script__operations__concurrent__publishes_once)
+{
+    const auto instance = script::factory(to_chunk(base16_literal(
+        "76a91418c0bd8d1818f1bf99cb1df2269c645318ef7b7388ac")), false);
+
+    std::vector<const operation::list*> results(4, nullptr);
+    std::vector<std::thread> threads;
+
+    for (size_t index = 0; index < results.size(); ++index)
+        threads.emplace_back([&instance, &results, index]()
+        {
+            results[index] = &instance.operations();
+        });
+
+    for (auto& thread: threads)
+        thread.join();
+
+    for (const auto result: results)
+        BOOST_REQUIRE(result == &instance.operations());
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__decoded__redecodes_operations)
+{
+    auto instance = script::factory(to_chunk(base16_literal("0201020303")),
+        false);
+    BOOST_REQUIRE_EQUAL(instance.operations().size(), 2u);
+
+    instance.find_and_delete({ to_chunk(base16_literal("0102")) });
+    BOOST_REQUIRE_EQUAL(instance.operations().size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__non_minimal_push__not_deleted)
+{
+    auto instance = script::factory(to_chunk(base16_literal("4c020102020102")),
+        false);
+    instance.find_and_delete({ to_chunk(base16_literal("0102")) });
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.bytes()), "4c020102");
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__invalid_tail__retained)
+{
+    auto instance = script::factory(to_chunk(base16_literal("0201024c05aa")),
+        false);
+    instance.find_and_delete({ to_chunk(base16_literal("0102")) });
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.bytes()), "4c05aa");
+}
+
+BOOST_AUTO_TEST_CASE(script__to_script_code__separators_and_endorsement__removed)
+{
+    const auto subscript = to_chunk(base16_literal("ab02010251ab020102"));
+    const auto endorsement = to_chunk(base16_literal("0102"));
+    const auto script_code = script::to_script_code(subscript, endorsement);
+    BOOST_REQUIRE_EQUAL(encode_base16(script_code), "51");
+}
+
+BOOST_AUTO_TEST_CASE(script__to_script_code__multiple_endorsements__all_removed)
+{
+    const auto subscript = to_chunk(base16_literal("0201020203045102010202030452"));
+    const auto first = to_chunk(base16_literal("0102"));
+    const auto second = to_chunk(base16_literal("0304"));
+    const auto script_code = script::to_script_code(subscript, { first, second });
+    BOOST_REQUIRE_EQUAL(encode_base16(script_code), "5152");
+}
+
+BOOST_AUTO_TEST_CASE(script__to_script_code__empty_endorsement__unchanged)
+{
+    const auto subscript = to_chunk(base16_literal("0051"));
+    const auto script_code = script::to_script_code(subscript, data_chunk{});
+    BOOST_REQUIRE_EQUAL(encode_base16(script_code), "0051");
+}
+
+BOOST_AUTO_TEST_CASE(script__to_script_code__invalid_tail__reserialized_as_invalid_operation)
+{
+    const auto subscript = to_chunk(base16_literal("ab514c05aa"));
+    const auto script_code = script::to_script_code(subscript, data_chunk{});
+    BOOST_REQUIRE_EQUAL(encode_base16(script_code), "5186");
+}
+
+BOOST_AUTO_TEST_CASE(script__generate_signature_hash__script_code__matches_script)
+{
+    const auto tx = template_tx();
+    const auto subscript = to_chunk(base16_literal("ab76a91488350574280395ad2c3e2ee20e322073d94e5e4088abac"));
+    const auto instance = script::factory(subscript, false);
+    const auto script_code = script::to_script_code(subscript, data_chunk{});
+    BOOST_REQUIRE_EQUAL(encode_base16(script_code), "76a91488350574280395ad2c3e2ee20e322073d94e5e4088ac");
+
+    const auto expected = script::generate_signature_hash(tx, 0, instance, sighash_algorithm::all);
+    const auto result = script::generate_signature_hash(tx, 0, script_code, sighash_algorithm::all);
+    BOOST_REQUIRE_EQUAL(encode_base16(result), encode_base16(expected));
+}
+
+
+// Analysis tests.
+//------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(script__analyze__pay_key_hash__one_sigop)
+{
+    const auto instance = script::factory(to_chunk(base16_literal("76a91488350574280395ad2c3e2ee20e322073d94e5e4088ac")), false);
+    const auto& analysis = instance.analyze();
+    BOOST_REQUIRE_EQUAL(analysis.sigops, 1u);
+    BOOST_REQUIRE_EQUAL(analysis.accurate_sigops, 1u);
+    BOOST_REQUIRE_EQUAL(analysis.embedded_sigops, 0u);
+    BOOST_REQUIRE(!analysis.push_only);
+    BOOST_REQUIRE(!analysis.relaxed_push);
+    BOOST_REQUIRE(!analysis.pay_script_hash);
+    BOOST_REQUIRE(analysis.valid_operations);
+}
+
+BOOST_AUTO_TEST_CASE(script__analyze__2_of_3_multisig__default_and_accurate_sigops)
+{
+    script instance;
+    instance.from_string(SCRIPT_2_OF_3_MULTISIG);
+    BOOST_REQUIRE_EQUAL(instance.sigops(false), multisig_default_sigops);
+    BOOST_REQUIRE_EQUAL(instance.sigops(true), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(script__analyze__pay_script_hash__matches_pattern)
+{
+    const script instance(script::to_pay_script_hash_pattern(null_short_hash));
+    BOOST_REQUIRE(instance.analyze().pay_script_hash);
+    BOOST_REQUIRE(script::is_pay_script_hash_pattern(instance.operations()));
+}
+
+BOOST_AUTO_TEST_CASE(script__analyze__reserved_80__relaxed_push_only)
+{
+    const auto instance = script::factory(to_chunk(base16_literal("0050")), false);
+    BOOST_REQUIRE(!instance.analyze().push_only);
+    BOOST_REQUIRE(instance.analyze().relaxed_push);
+    BOOST_REQUIRE(!script::is_push_only(instance.operations()));
+    BOOST_REQUIRE(script::is_relaxed_push(instance.operations()));
+}
+
+BOOST_AUTO_TEST_CASE(script__analyze__truncated_push__invalid_operations_counted_to_truncation)
+{
+    const auto instance = script::factory(to_chunk(base16_literal("51ac4c05aa")), false);
+    BOOST_REQUIRE_EQUAL(instance.sigops(false), 1u);
+    BOOST_REQUIRE(!instance.analyze().push_only);
+    BOOST_REQUIRE(!instance.is_valid_operations());
+    BOOST_REQUIRE(!instance.operations().back().is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(script__embedded_sigops__pay_script_hash_prevout__redeem_script_sigops)
+{
+    script redeem;
+    BOOST_REQUIRE(redeem.from_string(SCRIPT_2_OF_3_MULTISIG));
+    const auto redeem_data = redeem.to_data(false);
+    const script input(operation::list{ { opcode::push_size_0 }, { redeem_data } });
+    const script prevout(script::to_pay_script_hash_pattern(bitcoin_short_hash(redeem_data)));
+    BOOST_REQUIRE_EQUAL(input.analyze().embedded_sigops, 3u);
+    BOOST_REQUIRE_EQUAL(input.embedded_sigops(prevout), 3u);
+    BOOST_REQUIRE_EQUAL(input.embedded_sigops(redeem), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script__embedded_sigops__not_relaxed_push__zero)
+{
+    script redeem;
+    BOOST_REQUIRE(redeem.from_string(SCRIPT_2_OF_3_MULTISIG));
+    const auto redeem_data = redeem.to_data(false);
+    const script input(operation::list{ { opcode::nop }, { redeem_data } });
+    const script prevout(script::to_pay_script_hash_pattern(bitcoin_short_hash(redeem_data)));
+    BOOST_REQUIRE_EQUAL(input.embedded_sigops(prevout), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script__analyze__copy__shared)
+{
+    const auto instance = script::factory(to_chunk(base16_literal("51ac")), false);
+    const auto& analysis = instance.analyze();
+    const script copy(instance);
+    BOOST_REQUIRE(&copy.analyze() == &analysis);
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__analyzed__reanalyzes)
+{
+    auto instance = script::factory(to_chunk(base16_literal("510201acae")), false);
+    BOOST_REQUIRE_EQUAL(instance.sigops(true), multisig_default_sigops);
+
+    instance.find_and_delete({ to_chunk(base16_literal("01ac")) });
+    BOOST_REQUIRE_EQUAL(instance.sigops(true), 1u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static transaction make_tx(uint32_t version)
+{
+    return
+    {
+        version, 0,
+        input::list{ input{ output_point{ null_hash, 0 }, script{}, 0 } },
+        output::list{}
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(script_cache_tests)
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__empty__false_miss)
+{
+    const script_cache instance(10);
+    BOOST_REQUIRE(!instance.contains(make_tx(1), 0, 0));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__stored__true_hit)
+{
+    const auto tx = make_tx(1);
+    script_cache instance(10);
+    instance.store(tx, 0, 42);
+    BOOST_REQUIRE(instance.contains(tx, 0, 42));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__different_key_parts__false)
+{
+    const auto tx = make_tx(1);
+    script_cache instance(10);
+    instance.store(tx, 0, 42);
+    BOOST_REQUIRE(!instance.contains(make_tx(2), 0, 42));
+    BOOST_REQUIRE(!instance.contains(tx, 1, 42));
+    BOOST_REQUIRE(!instance.contains(tx, 0, 43));
+    BOOST_REQUIRE_EQUAL(instance.misses(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__store__duplicate__stored_once)
+{
+    const auto tx = make_tx(1);
+    script_cache instance(10);
+    instance.store(tx, 0, 0);
+    instance.store(tx, 0, 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__store__full__evicts_oldest)
+{
+    script_cache instance(2);
+    instance.store(make_tx(1), 0, 0);
+    instance.store(make_tx(2), 0, 0);
+    instance.store(make_tx(3), 0, 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(!instance.contains(make_tx(1), 0, 0));
+    BOOST_REQUIRE(instance.contains(make_tx(2), 0, 0));
+    BOOST_REQUIRE(instance.contains(make_tx(3), 0, 0));
+
+    instance.store(make_tx(4), 0, 0);
+    BOOST_REQUIRE(!instance.contains(make_tx(2), 0, 0));
+    BOOST_REQUIRE(instance.contains(make_tx(4), 0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__store__zero_capacity__not_stored)
+{
+    const auto tx = make_tx(1);
+    script_cache instance(0);
+    instance.store(tx, 0, 0);
+    BOOST_REQUIRE_EQUAL(instance.capacity(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.contains(tx, 0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__store__concurrent__all_stored)
+{
+    static const size_t count = 100;
+    script_cache instance(count * 4);
+    std::vector<std::thread> threads;
+
+    for (uint32_t thread = 0; thread < 4; ++thread)
+        threads.emplace_back([&instance, thread]()
+        {
+            const auto tx = make_tx(thread);
+
+            for (uint32_t index = 0; index < count; ++index)
+                instance.store(tx, index, 0);
+        });
+
+    for (auto& thread: threads)
+        thread.join();
+
+    BOOST_REQUIRE_EQUAL(instance.size(), count * 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+// Test helper (the signature hash by serialization of a reduced copy).
+static hash_digest reference_hash(const transaction& tx, uint32_t input_index,
+    const script& script_code, uint8_t sighash_type)
+{
+    const auto algorithm = sighash_type & sighash_algorithm::mask;
+    const auto single = algorithm == sighash_algorithm::single;
+    const auto none = algorithm == sighash_algorithm::none;
+    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
+    const auto& self = tx.inputs()[input_index];
+
+    input::list ins;
+
+    if (any)
+    {
+        ins.emplace_back(self.previous_output(), script_code, self.sequence());
+    }
+    else
+    {
+        for (const auto& input: tx.inputs())
+            ins.emplace_back(input.previous_output(), script{},
+                single || none ? 0 : input.sequence());
+
+        ins[input_index].set_script(script_code);
+        ins[input_index].set_sequence(self.sequence());
+    }
+
+    output::list outs;
+
+    if (single)
+    {
+        outs.resize(input_index + 1);
+        outs.back() = tx.outputs()[input_index];
+    }
+    else if (!none)
+    {
+        outs = tx.outputs();
+    }
+
+    return transaction(tx.version(), tx.locktime(), std::move(ins),
+        std::move(outs)).hash(sighash_type);
+}
+
+// Test helper.
+static transaction three_input_transaction()
+{
+    const auto p2kh = script::to_pay_key_hash_pattern(
+        base16_literal("88350574280395ad2c3e2ee20e322073d94e5e40"));
+
+    return
+    {
+        1, 42,
+        {
+            { { hash_literal("b3807042c92f449bbf79b33ca59d7dfec7f4cc71096704a9c526dddf496ee097"), 0 }, script{}, 1 },
+            { { hash_literal("dc38e9359bd7da3b58386204e186d9408685f427f5e513666db735aa8a6b2169"), 1 }, script{}, 2 },
+            { { hash_literal("315ac7d4c26d69668129cc352851d9389b4a6868f1509c6c8b66bead11e2619f"), 7 }, script{}, 3 }
+        },
+        {
+            { 1000, p2kh },
+            { 2000, script{ { { opcode::push_positive_1 } } } }
+        }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(sighash_cache_tests)
+
+BOOST_AUTO_TEST_CASE(sighash_cache__hash__all_types_all_inputs__matches_reference)
+{
+    const auto tx = three_input_transaction();
+    const sighash_cache cache(tx);
+    script script_code;
+    BOOST_REQUIRE(script_code.from_string("dup hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] equalverify checksig"));
+    const auto code = script_code.to_data(false);
+
+    const uint8_t types[] =
+    {
+        sighash_algorithm::all,
+        sighash_algorithm::none,
+        sighash_algorithm::single,
+        sighash_algorithm::all_anyone_can_pay,
+        sighash_algorithm::none_anyone_can_pay,
+        sighash_algorithm::single_anyone_can_pay,
+        0x00,
+        0x44
+    };
+
+    for (const auto type: types)
+    {
+        for (uint32_t index = 0; index < tx.inputs().size(); ++index)
+        {
+            const auto single = (type & sighash_algorithm::mask) == sighash_algorithm::single;
+
+            if (single && index >= tx.outputs().size())
+                continue;
+
+            BOOST_REQUIRE_EQUAL(encode_base16(cache.hash(index, code, type)), encode_base16(reference_hash(tx, index, script_code, type)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sighash_cache__hash__single_index_above_outputs__one_hash)
+{
+    const auto tx = three_input_transaction();
+    const sighash_cache cache(tx);
+    const auto expected = "0100000000000000000000000000000000000000000000000000000000000000";
+    BOOST_REQUIRE_EQUAL(encode_base16(cache.hash(2, data_chunk{}, sighash_algorithm::single)), expected);
+}
+
+BOOST_AUTO_TEST_CASE(sighash_cache__hash__index_above_inputs__one_hash)
+{
+    const auto tx = three_input_transaction();
+    const sighash_cache cache(tx);
+    const auto expected = "0100000000000000000000000000000000000000000000000000000000000000";
+    BOOST_REQUIRE_EQUAL(encode_base16(cache.hash(3, data_chunk{}, sighash_algorithm::all)), expected);
+}
+
+BOOST_AUTO_TEST_CASE(sighash_cache__transaction_sighash__changed_inputs__invalidated)
+{
+    auto tx = three_input_transaction();
+    const auto code = script::to_pay_key_hash_pattern(null_short_hash);
+    const auto before = tx.sighash()->hash(0, script(code).to_data(false), sighash_algorithm::all);
+    BOOST_REQUIRE(tx.sighash() == tx.sighash());
+
+    auto inputs = tx.inputs();
+    inputs[1].set_sequence(42);
+    tx.set_inputs(std::move(inputs));
+    const auto after = tx.sighash()->hash(0, script(code).to_data(false), sighash_algorithm::all);
+    BOOST_REQUIRE(before != after);
+    BOOST_REQUIRE(after == reference_hash(tx, 0, code, sighash_algorithm::all));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -476,6 +476,15 @@ BOOST_AUTO_TEST_CASE(transaction__from_data__compare_wire_to_store__success)
     BOOST_REQUIRE(wire_tx == store_tx);
 }
 
+BOOST_AUTO_TEST_CASE(transaction__from_data__store_with_hash__preserves_hash)
+{
+    const auto data_store = to_chunk(base16_literal(TX3_STORE_SERIALIZED_V3));
+    auto source = make_safe_deserializer(data_store.begin(), data_store.end());
+    chain::transaction store_tx;
+    BOOST_REQUIRE(store_tx.from_data(source, null_hash));
+    BOOST_REQUIRE(store_tx.hash() == null_hash);
+}
+
 BOOST_AUTO_TEST_CASE(transaction__factory_data_1__case_1__success)
 {
     static const auto tx_hash = hash_literal(TX1_HASH);
@@ -509,6 +518,28 @@ BOOST_AUTO_TEST_CASE(transaction__factory_data_1__case_2__success)
     BOOST_REQUIRE(resave == raw_tx);
 }
 
+BOOST_AUTO_TEST_CASE(transaction__factory_data_1__hash__matches_computed_hash)
+{
+    static const auto tx_hash = hash_literal(TX4_HASH);
+    static const auto raw_tx = to_chunk(base16_literal(TX4));
+
+    const auto tx = chain::transaction::factory(raw_tx, true, true);
+    BOOST_REQUIRE(tx.is_valid());
+    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.hash() == bitcoin_hash(tx.to_data()));
+}
+
+BOOST_AUTO_TEST_CASE(transaction__factory_data_1__hash_trailing_bytes__excludes_trailing_bytes)
+{
+    static const auto tx_hash = hash_literal(TX1_HASH);
+    auto raw_tx = to_chunk(base16_literal(TX1));
+    raw_tx.push_back(0x42);
+
+    const auto tx = chain::transaction::factory(raw_tx, true, true);
+    BOOST_REQUIRE(tx.is_valid());
+    BOOST_REQUIRE(tx.hash() == tx_hash);
+}
+
 BOOST_AUTO_TEST_CASE(transaction__factory_data_2__case_1__success)
 {
     static const auto tx_hash = hash_literal(TX1_HASH);
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+static script make_script(const std::string& mnemonic)
+{
+    script out;
+    BOOST_REQUIRE(out.from_string(mnemonic));
+    return out;
+}
+
+BOOST_AUTO_TEST_SUITE(bytecode_tests)
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__default__valid_empty)
+{
+    bytecode instance;
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(!instance.is_disabled());
+    BOOST_REQUIRE(instance.instructions().empty());
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__compile__pay_key_hash__shared_by_all_instances)
+{
+    const auto first = make_script("dup hash160 [0000000000000000000000000000000000000001] equalverify checksig");
+    const auto second = make_script("dup hash160 [ffffffffffffffffffffffffffffffffffffffff] equalverify checksig");
+    const auto first_code = bytecode::compile(first.bytes());
+    const auto second_code = bytecode::compile(second.bytes());
+    BOOST_REQUIRE(first_code == second_code);
+    BOOST_REQUIRE(first_code->is_valid());
+    BOOST_REQUIRE_EQUAL(first_code->instructions().size(), 5u);
+
+    const auto& push = first_code->instructions()[2];
+    BOOST_REQUIRE(push.code == opcode::push_size_20);
+    BOOST_REQUIRE_EQUAL(push.position, 2u);
+    BOOST_REQUIRE_EQUAL(push.offset, 3u);
+    BOOST_REQUIRE_EQUAL(push.size, 20u);
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__compile__pay_script_hash__shared_by_all_instances)
+{
+    const auto first = make_script("hash160 [0000000000000000000000000000000000000001] equal");
+    const auto second = make_script("hash160 [ffffffffffffffffffffffffffffffffffffffff] equal");
+    BOOST_REQUIRE(bytecode::compile(first.bytes()) == bytecode::compile(second.bytes()));
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__compile__nonstandard__not_shared)
+{
+    const auto instance = make_script("dup hash160 [0000000000000000000000000000000000000001] equal");
+    BOOST_REQUIRE(bytecode::compile(instance.bytes()) != bytecode::compile(instance.bytes()));
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__push_one_size__offset_after_size)
+{
+    // push_one_size, size 2, data, nop
+    const auto data = to_chunk(base16_literal("4c02abcd61"));
+    const bytecode instance(data);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.instructions().size(), 2u);
+
+    const auto& push = instance.instructions()[0];
+    BOOST_REQUIRE(push.code == opcode::push_one_size);
+    BOOST_REQUIRE_EQUAL(push.position, 0u);
+    BOOST_REQUIRE_EQUAL(push.offset, 2u);
+    BOOST_REQUIRE_EQUAL(push.size, 2u);
+    BOOST_REQUIRE(instance.instructions()[1].code == opcode::nop);
+    BOOST_REQUIRE_EQUAL(instance.instructions()[1].position, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__truncated_push__invalid)
+{
+    const auto data = to_chunk(base16_literal("03abcd"));
+    const bytecode instance(data);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__truncated_push_size__invalid)
+{
+    const auto data = to_chunk(base16_literal("4d02"));
+    const bytecode instance(data);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__oversized_push__invalid)
+{
+    // push_two_size of max_push_data_size + 1 bytes.
+    data_chunk data{ 0x4d, 0x09, 0x02 };
+    data.resize(data.size() + max_push_data_size + 1, 0x00);
+    const bytecode instance(data);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__disabled__instructions_end_before)
+{
+    // nop, cat, nop
+    const auto data = to_chunk(base16_literal("617e61"));
+    const bytecode instance(data);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(instance.is_disabled());
+    BOOST_REQUIRE_EQUAL(instance.instructions().size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__constructor__disabled_then_truncated__invalid)
+{
+    // cat, truncated push
+    const auto data = to_chunk(base16_literal("7e03ab"));
+    const bytecode instance(data);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__evaluate__disabled_in_unexecuted_branch__op_disabled)
+{
+    const auto instance = make_script("0 if cat endif 1");
+    program program(instance);
+    BOOST_REQUIRE_EQUAL(program.evaluate(), error::op_disabled);
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__evaluate__codeseparator__subscript_follows)
+{
+    const auto instance = make_script("1 codeseparator [abcd] 2");
+    const auto expected = make_script("[abcd] 2");
+    program program(instance);
+    BOOST_REQUIRE_EQUAL(program.evaluate(), error::success);
+    BOOST_REQUIRE_EQUAL(program.jump(), 2u);
+    BOOST_REQUIRE(program.subscript() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__evaluate_operation__codeseparator__subscript_follows)
+{
+    const auto instance = make_script("1 codeseparator [abcd] 2");
+    const auto expected = make_script("[abcd] 2");
+    program program(instance);
+    BOOST_REQUIRE_EQUAL(program.evaluate(instance[1]), error::success);
+    BOOST_REQUIRE_EQUAL(program.jump(), 2u);
+    BOOST_REQUIRE(program.subscript() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__evaluate__push_data__copied_from_script)
+{
+    const auto instance = make_script("[abcd] [0102030405]");
+    program program(instance);
+    BOOST_REQUIRE_EQUAL(program.evaluate(), error::success);
+    BOOST_REQUIRE_EQUAL(program.size(), 2u);
+    BOOST_REQUIRE_EQUAL(encode_base16(program.item(0)), "0102030405");
+    BOOST_REQUIRE_EQUAL(encode_base16(program.item(1)), "abcd");
+}
+
+BOOST_AUTO_TEST_CASE(bytecode__is_unspendable__return_first__true)
+{
+    BOOST_REQUIRE(make_script("return [abcd]").is_unspendable());
+    BOOST_REQUIRE(!make_script("[abcd] return").is_unspendable());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,7 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <limits>
@@ -445,4 +446,28 @@ BOOST_AUTO_TEST_CASE(make_operator_expectations)
 }
 #endif
 
+BOOST_AUTO_TEST_CASE(number__data__encoding__matches_chunk_and_round_trips)
+{
+    static const int64_t values[]
+    {
+        0, 1, -1, 127, -127, 128, -128, 255, -255, 256, 32767, -32768,
+        8388608, -8388608, 2147483647, -2147483647, 4294967296,
+        9223372036854775807, -9223372036854775807
+    };
+
+    for (const auto value: values)
+    {
+        const number instance(value);
+        number::encoding buffer;
+        const auto size = instance.data(buffer);
+        const auto expected = instance.data();
+        BOOST_REQUIRE_EQUAL(size, expected.size());
+        BOOST_REQUIRE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+
+        number decoded;
+        BOOST_REQUIRE(decoded.set_data(data_slice(buffer.data(), buffer.data() + size), buffer.size()));
+        BOOST_REQUIRE_EQUAL(decoded.int64(), value);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
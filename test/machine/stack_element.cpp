@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::machine;
+
+BOOST_AUTO_TEST_SUITE(stack_element_tests)
+
+BOOST_AUTO_TEST_CASE(stack_element__constructor__default__empty_inline)
+{
+    const stack_element instance;
+    BOOST_REQUIRE(instance.empty());
+    BOOST_REQUIRE(instance.is_inline());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.begin() == instance.end());
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__constructor__initializer_list__expected)
+{
+    const stack_element instance{ 0x01, 0x02, 0x03 };
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.front(), 0x01);
+    BOOST_REQUIRE_EQUAL(instance[1], 0x02);
+    BOOST_REQUIRE_EQUAL(instance.back(), 0x03);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__constructor__inline_capacity__inline)
+{
+    const data_chunk data(stack_element::inline_capacity, 0x42);
+    const stack_element instance(data);
+    BOOST_REQUIRE(instance.is_inline());
+    BOOST_REQUIRE(to_chunk(instance) == data);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__constructor__above_inline_capacity__heap)
+{
+    const data_chunk data(stack_element::inline_capacity + 1, 0x42);
+    const stack_element instance(data);
+    BOOST_REQUIRE(!instance.is_inline());
+    BOOST_REQUIRE(to_chunk(instance) == data);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__constructor__hash__expected)
+{
+    const auto hash = bitcoin_short_hash(data_chunk{ 0x61, 0x62, 0x63 });
+    const stack_element instance(hash);
+    BOOST_REQUIRE_EQUAL(instance.size(), short_hash_size);
+    BOOST_REQUIRE_EQUAL(encode_base16(instance), encode_base16(hash));
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__copy_constructor__heap__independent_copy)
+{
+    const data_chunk data(520, 0x42);
+    const stack_element instance(data);
+    const stack_element copy(instance);
+    BOOST_REQUIRE(!copy.is_inline());
+    BOOST_REQUIRE(copy.data() != instance.data());
+    BOOST_REQUIRE(copy == instance);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__move_constructor__heap__takes_buffer)
+{
+    const data_chunk data(520, 0x42);
+    stack_element instance(data);
+    const auto buffer = instance.data();
+    const stack_element moved(std::move(instance));
+    BOOST_REQUIRE(moved.data() == buffer);
+    BOOST_REQUIRE(instance.empty());
+    BOOST_REQUIRE(to_chunk(moved) == data);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__move_assign__inline_over_heap__expected)
+{
+    stack_element instance(data_chunk(520, 0x42));
+    stack_element other{ 0x2a };
+    instance = std::move(other);
+    BOOST_REQUIRE(instance.is_inline());
+    BOOST_REQUIRE(instance == stack_element{ 0x2a });
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__copy_assign__heap_over_inline__expected)
+{
+    const stack_element other(data_chunk(100, 0x42));
+    stack_element instance{ 0x2a };
+    instance = other;
+    BOOST_REQUIRE(!instance.is_inline());
+    BOOST_REQUIRE(instance == other);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__equality__different_sizes__false)
+{
+    const stack_element left{ 0x00 };
+    const stack_element right{ 0x00, 0x00 };
+    BOOST_REQUIRE(left != right);
+    BOOST_REQUIRE(!(left == right));
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__program__push_pop__round_trips)
+{
+    program instance;
+    const data_chunk large(200, 0x42);
+    instance.push_copy(large);
+    const stack_element small{ 0x01, 0x02 };
+    instance.push_copy(small);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(instance.pop() == small);
+    BOOST_REQUIRE(to_chunk(instance.pop()) == large);
+    BOOST_REQUIRE(instance.empty());
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__program__successive_programs__empty_stacks)
+{
+    {
+        program first;
+        first.push(true);
+        first.push_alternate({ 0x01 });
+    }
+
+    // Recycled stacks are cleared before reuse.
+    program second;
+    BOOST_REQUIRE(second.empty());
+    BOOST_REQUIRE(second.empty_alternate());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
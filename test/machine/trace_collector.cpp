@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::machine;
+
+static evaluation_trace make_trace(uint32_t index, size_t microseconds)
+{
+    evaluation_trace trace;
+    trace.index = index;
+    trace.duration = std::chrono::microseconds(microseconds);
+    return trace;
+}
+
+BOOST_AUTO_TEST_SUITE(trace_collector_tests)
+
+BOOST_AUTO_TEST_CASE(trace_collector__construct__empty)
+{
+    const trace_collector instance(3);
+    BOOST_REQUIRE_EQUAL(instance.inputs(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.templated(), 0u);
+    BOOST_REQUIRE(instance.duration() == asio::duration::zero());
+    BOOST_REQUIRE_EQUAL(instance.stack_high_water(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.signature_hashes(), 0u);
+    BOOST_REQUIRE(instance.worst().empty());
+}
+
+BOOST_AUTO_TEST_CASE(trace_collector__collect__two__aggregated)
+{
+    auto first = make_trace(0, 10);
+    first.templated = true;
+    first.stack_high_water = 4;
+    first.signature_hashes = 1;
+    first.operations[static_cast<uint8_t>(opcode::checksig)] = 1;
+
+    auto second = make_trace(1, 20);
+    second.stack_high_water = 7;
+    second.signature_hashes = 2;
+    second.operations[static_cast<uint8_t>(opcode::checksig)] = 2;
+    second.operations[static_cast<uint8_t>(opcode::dup)] = 1;
+
+    trace_collector instance(3);
+    instance.collect(first);
+    instance.collect(second);
+    BOOST_REQUIRE_EQUAL(instance.inputs(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.templated(), 1u);
+    BOOST_REQUIRE(instance.duration() == std::chrono::microseconds(30));
+    BOOST_REQUIRE_EQUAL(instance.stack_high_water(), 7u);
+    BOOST_REQUIRE_EQUAL(instance.signature_hashes(), 3u);
+
+    const auto operations = instance.operations();
+    BOOST_REQUIRE_EQUAL(operations[static_cast<uint8_t>(opcode::checksig)], 3u);
+    BOOST_REQUIRE_EQUAL(operations[static_cast<uint8_t>(opcode::dup)], 1u);
+    BOOST_REQUIRE_EQUAL(operations[static_cast<uint8_t>(opcode::add)], 0u);
+}
+
+BOOST_AUTO_TEST_CASE(trace_collector__worst__more_than_worst__slowest_first)
+{
+    trace_collector instance(3);
+    instance.collect(make_trace(0, 50));
+    instance.collect(make_trace(1, 10));
+    instance.collect(make_trace(2, 40));
+    instance.collect(make_trace(3, 20));
+    instance.collect(make_trace(4, 60));
+
+    const auto worst = instance.worst();
+    BOOST_REQUIRE_EQUAL(instance.inputs(), 5u);
+    BOOST_REQUIRE_EQUAL(worst.size(), 3u);
+    BOOST_REQUIRE_EQUAL(worst[0].index, 4u);
+    BOOST_REQUIRE_EQUAL(worst[1].index, 0u);
+    BOOST_REQUIRE_EQUAL(worst[2].index, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(trace_collector__worst__equal_durations__first_retained)
+{
+    trace_collector instance(1);
+    instance.collect(make_trace(0, 10));
+    instance.collect(make_trace(1, 10));
+
+    const auto worst = instance.worst();
+    BOOST_REQUIRE_EQUAL(worst.size(), 1u);
+    BOOST_REQUIRE_EQUAL(worst.front().index, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(trace_collector__worst__zero__empty_aggregated)
+{
+    trace_collector instance(0);
+    instance.collect(make_trace(0, 10));
+    BOOST_REQUIRE_EQUAL(instance.inputs(), 1u);
+    BOOST_REQUIRE(instance.worst().empty());
+}
+
+BOOST_AUTO_TEST_CASE(trace_collector__clear__collected__empty)
+{
+    trace_collector instance(2);
+    instance.collect(make_trace(0, 10));
+    instance.clear();
+    BOOST_REQUIRE_EQUAL(instance.inputs(), 0u);
+    BOOST_REQUIRE(instance.duration() == asio::duration::zero());
+    BOOST_REQUIRE(instance.worst().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -58,6 +58,138 @@ BOOST_AUTO_TEST_CASE(sha256_hash_test)
     BOOST_REQUIRE_EQUAL(encode_base16(hash), "3a6eb0790f39ac87c94f3856b2dd2c5d110e6811602261a9a923d3bb23adc8b7");
 }
 
+BOOST_AUTO_TEST_CASE(sha256_hash__multiple_blocks__expected)
+{
+    // Exercises the multiple block transform path.
+    const data_chunk chunk(1000, 'a');
+    const auto hash = sha256_hash(chunk);
+    BOOST_REQUIRE_EQUAL(encode_base16(hash), "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hash_64__all_lane_counts__expected)
+{
+    // Covers every remainder of the 8 and 4 lane batches.
+    for (size_t count = 0; count <= 17; ++count)
+    {
+        data_chunk messages(count * long_hash_size);
+        for (size_t index = 0; index < messages.size(); ++index)
+            messages[index] = static_cast<uint8_t>(index * 7 + count);
+
+        data_chunk digests(count * hash_size);
+        bitcoin_hash_64(digests.data(), messages.data(), count);
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            const auto message = messages.data() + index * long_hash_size;
+            const auto digest = digests.begin() + index * hash_size;
+            const auto expected = bitcoin_hash({ message, message + long_hash_size });
+            BOOST_REQUIRE(std::equal(digest, digest + hash_size,
+                expected.begin()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hash_64__in_place__expected)
+{
+    static const size_t count = 13;
+    data_chunk buffer(count * long_hash_size);
+    for (size_t index = 0; index < buffer.size(); ++index)
+        buffer[index] = static_cast<uint8_t>(index);
+
+    hash_list expected;
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto message = buffer.data() + index * long_hash_size;
+        expected.push_back(bitcoin_hash({ message, message + long_hash_size }));
+    }
+
+    bitcoin_hash_64(buffer.data(), buffer.data(), count);
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto digest = buffer.begin() + index * hash_size;
+        BOOST_REQUIRE(std::equal(digest, digest + hash_size,
+            expected[index].begin()));
+    }
+}
+
+// Test helper (unoptimized reference).
+static hash_digest reference_merkle_root(hash_list level)
+{
+    while (level.size() > 1)
+    {
+        if (level.size() % 2 != 0)
+            level.push_back(level.back());
+
+        hash_list parents;
+        for (size_t index = 0; index < level.size(); index += 2)
+            parents.push_back(bitcoin_hash(
+                build_chunk({ level[index], level[index + 1] })));
+
+        level = parents;
+    }
+
+    return level.front();
+}
+
+static hash_list merkle_leaves(size_t count)
+{
+    hash_list leaves;
+    for (size_t index = 0; index < count; ++index)
+        leaves.push_back(sha256_hash(to_chunk(static_cast<uint8_t>(index))));
+
+    return leaves;
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root__empty__null_hash)
+{
+    BOOST_REQUIRE(merkle_root({}) == null_hash);
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root__one__itself)
+{
+    const auto leaves = merkle_leaves(1);
+    BOOST_REQUIRE(merkle_root(leaves) == leaves.front());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root__various_counts__expected)
+{
+    for (size_t count = 2; count <= 33; ++count)
+    {
+        const auto leaves = merkle_leaves(count);
+        BOOST_REQUIRE(merkle_root(leaves) == reference_merkle_root(leaves));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merkle_branch__out_of_range__empty)
+{
+    BOOST_REQUIRE(merkle_branch(merkle_leaves(3), 3).empty());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_branch__each_index__folds_to_root)
+{
+    const auto leaves = merkle_leaves(11);
+    const auto root = merkle_root(leaves);
+
+    for (size_t index = 0; index < leaves.size(); ++index)
+    {
+        auto position = index;
+        auto hash = leaves[index];
+        const auto branch = merkle_branch(leaves, index);
+        BOOST_REQUIRE_EQUAL(branch.size(), 4u);
+
+        for (const auto& sibling: branch)
+        {
+            hash = position % 2 == 0 ?
+                bitcoin_hash(build_chunk({ hash, sibling })) :
+                bitcoin_hash(build_chunk({ sibling, hash }));
+            position /= 2;
+        }
+
+        BOOST_REQUIRE(hash == root);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(sha512_hash_test)
 {
     const data_chunk chunk{ 'd', 'a', 't', 'a' };
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(signature_batch_tests)
+
+#define SECRET1 "8010b1bb119ad37d4b65a1022a314897b1b3614b345974332cb1b9582cf03536"
+#define SECRET2 "ce8f4b713ffdd2658900845251890f30371856be201cd1f5b3d970f793634333"
+
+// Test helper (alternating keys, with every third hash mismatched).
+static void populate(signature_batch& batch, size_t count)
+{
+    const ec_secret secrets[] =
+    {
+        base16_literal(SECRET1),
+        base16_literal(SECRET2)
+    };
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto& secret = secrets[(index / 4) % 2];
+        const auto hash = bitcoin_hash(to_chunk(static_cast<uint8_t>(index)));
+
+        ec_compressed point;
+        ec_signature signature;
+        BOOST_REQUIRE(secret_to_public(point, secret));
+        BOOST_REQUIRE(sign(signature, secret, hash));
+
+        const auto signed_hash = index % 3 == 2 ? null_hash : hash;
+        BOOST_REQUIRE_EQUAL(batch.push(point, signed_hash, signature), index);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(signature_batch__verify__empty__true)
+{
+    signature_batch batch;
+    BOOST_REQUIRE(batch.empty());
+    BOOST_REQUIRE(batch.verify());
+}
+
+BOOST_AUTO_TEST_CASE(signature_batch__verify__all_valid__true)
+{
+    signature_batch batch;
+    const ec_secret secret = base16_literal(SECRET1);
+    const auto hash = bitcoin_hash(to_chunk(uint8_t(42)));
+
+    ec_uncompressed point;
+    ec_signature signature;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    BOOST_REQUIRE(sign(signature, secret, hash));
+    batch.push(point, hash, signature);
+    batch.push(point, hash, signature);
+
+    BOOST_REQUIRE(batch.verify());
+    BOOST_REQUIRE(batch.is_valid(0));
+    BOOST_REQUIRE(batch.is_valid(1));
+    BOOST_REQUIRE(!batch.is_valid(2));
+}
+
+BOOST_AUTO_TEST_CASE(signature_batch__verify__invalid_point__false)
+{
+    signature_batch batch;
+    const ec_secret secret = base16_literal(SECRET1);
+    const auto hash = bitcoin_hash(to_chunk(uint8_t(42)));
+
+    ec_signature signature;
+    BOOST_REQUIRE(sign(signature, secret, hash));
+    batch.push(data_chunk{ 0x02, 0x42 }, hash, signature);
+    batch.push(data_chunk(ec_uncompressed_size + 1, 0x04), hash, signature);
+
+    BOOST_REQUIRE(!batch.verify());
+    BOOST_REQUIRE(!batch.is_valid(0));
+    BOOST_REQUIRE(!batch.is_valid(1));
+}
+
+BOOST_AUTO_TEST_CASE(signature_batch__verify__mixed__expected_results)
+{
+    signature_batch batch;
+    populate(batch, 40);
+    BOOST_REQUIRE_EQUAL(batch.size(), 40u);
+    BOOST_REQUIRE(!batch.verify());
+
+    for (size_t index = 0; index < batch.size(); ++index)
+        BOOST_REQUIRE_EQUAL(batch.is_valid(index), index % 3 != 2);
+}
+
+BOOST_AUTO_TEST_CASE(signature_batch__verify_dispatch__mixed__expected_results)
+{
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    signature_batch batch;
+    populate(batch, 100);
+    BOOST_REQUIRE(!batch.verify(dispatch));
+
+    for (size_t index = 0; index < batch.size(); ++index)
+        BOOST_REQUIRE_EQUAL(batch.is_valid(index), index % 3 != 2);
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(signature_batch__clear__populated__empty)
+{
+    signature_batch batch;
+    populate(batch, 3);
+    batch.clear();
+    BOOST_REQUIRE(batch.empty());
+    BOOST_REQUIRE(batch.verify());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -137,6 +137,54 @@ BOOST_AUTO_TEST_CASE(merkle_block__constructor_5__always__equals_params)
     BOOST_REQUIRE(flags == instance.flags());
 }
 
+static chain::block three_transaction_block()
+{
+    chain::transaction::list transactions
+    {
+        { 1, 0, {}, {} },
+        { 1, 1, {}, {} },
+        { 1, 2, {}, {} }
+    };
+
+    return { chain::header{}, std::move(transactions) };
+}
+
+BOOST_AUTO_TEST_CASE(merkle_block__constructor_6__no_matches__root_only)
+{
+    const auto block = three_transaction_block();
+    const message::merkle_block instance(block, {});
+    BOOST_REQUIRE_EQUAL(instance.total_transactions(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.hashes().size(), 1u);
+    BOOST_REQUIRE(instance.hashes().front() == block.generate_merkle_root());
+    BOOST_REQUIRE(instance.flags() == data_chunk{ 0x00 });
+}
+
+BOOST_AUTO_TEST_CASE(merkle_block__constructor_6__middle_match__expected_tree)
+{
+    const auto block = three_transaction_block();
+    const auto hashes = block.to_hashes();
+    const message::merkle_block instance(block, { false, true, false });
+
+    // Traversal bits are 1, 1, 0, 1, 0 (packed least significant first).
+    const hash_list expected
+    {
+        hashes[0],
+        hashes[1],
+        bitcoin_hash(build_chunk({ hashes[2], hashes[2] }))
+    };
+
+    BOOST_REQUIRE(instance.hashes() == expected);
+    BOOST_REQUIRE(instance.flags() == data_chunk{ 0x0b });
+}
+
+BOOST_AUTO_TEST_CASE(merkle_block__constructor_6__single_transaction__leaf)
+{
+    const chain::block block{ chain::header{}, { { 1, 0, {}, {} } } };
+    const message::merkle_block instance(block, { true });
+    BOOST_REQUIRE(instance.hashes() == block.to_hashes());
+    BOOST_REQUIRE(instance.flags() == data_chunk{ 0x01 });
+}
+
 BOOST_AUTO_TEST_CASE(from_data_insufficient_data_fails)
 {
     const data_chunk data{ 10 };
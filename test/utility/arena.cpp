@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(arena_tests)
+
+BOOST_AUTO_TEST_CASE(arena__constructor__default__reserves_nothing)
+{
+    arena instance;
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(arena__allocate__small__shares_region)
+{
+    arena instance(1024);
+    const auto first = static_cast<uint8_t*>(instance.allocate(10, 1));
+    const auto second = static_cast<uint8_t*>(instance.allocate(10, 1));
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 1024u);
+    BOOST_REQUIRE(second == first + 10);
+}
+
+BOOST_AUTO_TEST_CASE(arena__allocate__alignment__aligned)
+{
+    arena instance(1024);
+    instance.allocate(1, 1);
+    const auto pointer = instance.allocate(8, 8);
+    BOOST_REQUIRE_EQUAL(reinterpret_cast<uintptr_t>(pointer) % 8, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(arena__allocate__exhausted__adds_region)
+{
+    arena instance(64);
+    instance.allocate(60, 1);
+    instance.allocate(60, 1);
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 128u);
+}
+
+BOOST_AUTO_TEST_CASE(arena__allocate__oversized__preserves_current_region)
+{
+    arena instance(64);
+    const auto first = static_cast<uint8_t*>(instance.allocate(10, 1));
+    instance.allocate(100, 1);
+    const auto second = static_cast<uint8_t*>(instance.allocate(10, 1));
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 64u + 100u);
+    BOOST_REQUIRE(second == first + 10);
+}
+
+BOOST_AUTO_TEST_CASE(arena__release__allocated__reserves_nothing)
+{
+    arena instance(64);
+    instance.allocate(10, 1);
+    instance.release();
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(arena_allocator__vector__push_back__expected)
+{
+    arena instance(256);
+    arena_allocator<uint32_t> allocator(instance);
+    std::vector<uint32_t, arena_allocator<uint32_t>> values(allocator);
+
+    for (uint32_t value = 0; value < 100; ++value)
+        values.push_back(value);
+
+    BOOST_REQUIRE_EQUAL(values.size(), 100u);
+    BOOST_REQUIRE_EQUAL(values[42], 42u);
+    BOOST_REQUIRE(instance.reserved() != 0);
+}
+
+BOOST_AUTO_TEST_CASE(arena_allocator__unordered_set__rebinds__expected)
+{
+    typedef arena_allocator<hash_digest> allocator;
+    typedef std::unordered_set<hash_digest, std::hash<hash_digest>,
+        std::equal_to<hash_digest>, allocator> hash_set;
+
+    arena instance;
+    hash_set hashes(8, std::hash<hash_digest>(), std::equal_to<hash_digest>(),
+        allocator(instance));
+
+    hashes.insert(null_hash);
+    hashes.insert(bitcoin_hash(data_chunk{ 42 }));
+    hashes.insert(null_hash);
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2u);
+    BOOST_REQUIRE_EQUAL(hashes.count(null_hash), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(arena_allocator__equality__same_arena__true)
+{
+    arena instance;
+    const arena_allocator<uint8_t> left(instance);
+    const arena_allocator<uint64_t> right(instance);
+    BOOST_REQUIRE(left == right);
+}
+
+BOOST_AUTO_TEST_CASE(arena_allocator__equality__different_arena__false)
+{
+    arena first;
+    arena second;
+    const arena_allocator<uint8_t> left(first);
+    const arena_allocator<uint8_t> right(second);
+    BOOST_REQUIRE(left != right);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
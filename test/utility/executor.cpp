@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(executor_tests)
+
+BOOST_AUTO_TEST_CASE(executor__size__four_threads__four)
+{
+    executor instance(4);
+    BOOST_REQUIRE_EQUAL(instance.size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(executor__concurrent__no_threads__dropped)
+{
+    executor instance;
+    auto ran = false;
+    instance.concurrent([&ran]() { ran = true; });
+    instance.shutdown();
+    instance.join();
+    BOOST_REQUIRE(!ran);
+}
+
+BOOST_AUTO_TEST_CASE(executor__shutdown__queued_jobs__all_complete)
+{
+    static const size_t jobs = 10000;
+    std::atomic<size_t> count(0);
+
+    executor instance(4);
+
+    for (size_t index = 0; index < jobs; ++index)
+        instance.concurrent([&count]() { ++count; });
+
+    instance.shutdown();
+    instance.join();
+    BOOST_REQUIRE_EQUAL(count.load(), jobs);
+}
+
+BOOST_AUTO_TEST_CASE(executor__concurrent__nested__all_complete)
+{
+    static const size_t roots = 100;
+    static const size_t children = 100;
+    std::atomic<size_t> count(0);
+    std::promise<void> done;
+
+    executor instance(4);
+
+    const auto complete = [&]()
+    {
+        if (++count == roots * children)
+            done.set_value();
+    };
+
+    for (size_t root = 0; root < roots; ++root)
+    {
+        instance.concurrent([&]()
+        {
+            for (size_t child = 0; child < children; ++child)
+                instance.concurrent(complete);
+        });
+    }
+
+    done.get_future().wait();
+    BOOST_REQUIRE_EQUAL(count.load(), roots * children);
+}
+
+BOOST_AUTO_TEST_CASE(executor__concurrent__after_shutdown__dropped)
+{
+    std::atomic<size_t> count(0);
+
+    executor instance(2);
+    instance.shutdown();
+    instance.concurrent([&count]() { ++count; });
+    instance.join();
+    BOOST_REQUIRE_EQUAL(count.load(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(executor__dispatcher_parallel__executor__all_elements)
+{
+    const std::vector<size_t> elements{ 1, 2, 3, 4, 5, 6, 7, 8 };
+    std::atomic<size_t> sum(0);
+    std::promise<code> result;
+
+    threadpool pool(1);
+    executor instance(4);
+    dispatcher dispatch(pool, instance, "test");
+    BOOST_REQUIRE_EQUAL(dispatch.size(), 4u);
+
+    const auto add = [&sum](size_t element, std::function<void(code)> call)
+    {
+        sum += element;
+        call(error::success);
+    };
+
+    dispatch.parallel(elements, "parallel", [&result](const code& ec)
+    {
+        result.set_value(ec);
+    }, add);
+
+    BOOST_REQUIRE_EQUAL(result.get_future().get(), error::success);
+    BOOST_REQUIRE_EQUAL(sum.load(), 36u);
+    instance.shutdown();
+    instance.join();
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(executor__dispatcher_race__executor__first_result)
+{
+    std::atomic<size_t> calls(0);
+    std::promise<code> result;
+
+    threadpool pool(1);
+    executor instance(4);
+    dispatcher dispatch(pool, instance, "test");
+
+    const auto fail = [&calls](std::function<void(code)> call)
+    {
+        ++calls;
+        call(error::operation_failed);
+    };
+
+    dispatch.race(8, "race", [&result](const code& ec)
+    {
+        result.set_value(ec);
+    }, fail);
+
+    BOOST_REQUIRE_EQUAL(result.get_future().get(), error::operation_failed);
+    instance.shutdown();
+    instance.join();
+    BOOST_REQUIRE_EQUAL(calls.load(), 8u);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -61,6 +61,15 @@ BOOST_AUTO_TEST_CASE(deserializer_exhaustion)
     BOOST_REQUIRE(!reader);
 }
 
+BOOST_AUTO_TEST_CASE(deserializer__read_bytes__insufficient__invalid_sized)
+{
+    const data_chunk data{ 0x01, 0x02, 0x03 };
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    BOOST_REQUIRE(source.read_bytes(2) == (data_chunk{ 0x01, 0x02 }));
+    BOOST_REQUIRE_EQUAL(source.read_bytes(2).size(), 2u);
+    BOOST_REQUIRE(!source);
+}
+
 BOOST_AUTO_TEST_CASE(is_exhausted_initialized_empty_stream_returns_true)
 {
     data_chunk data(0);